@@ -133,5 +133,10 @@ void OPL_SetPaused(int paused);
 
 int OPL_FillBuffer(unsigned char *buffer, int buffer_samples);
 
+// Number of samples generated so far. Inside a callback this is the exact
+// sample at which the callback fires.
+
+uint64_t OPL_GetSamplePosition(void);
+
 #endif
 
@@ -1373,3 +1373,15 @@ void OPL3_GenerateStream(opl3_chip *chip, Bit16s *sndptr, Bit32u numsamples)
         sndptr += 2;
     }
 }
+
+/* Render numsamples at the chip's native rate, same as repeated OPL3_Generate calls. */
+void OPL3_GenerateBlock(opl3_chip *chip, Bit16s *sndptr, Bit32u numsamples)
+{
+    Bit32u i;
+
+    for(i = 0; i < numsamples; i++)
+    {
+        OPL3_Generate(chip, sndptr);
+        sndptr += 2;
+    }
+}
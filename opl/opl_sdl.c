@@ -15,9 +15,14 @@
 //     OPL SDL interface.
 //
 
+#include <SDL3/SDL.h>
+
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "doomtype.h"
+#include "i_system.h"
 #include "opl.h"
 #include "opl3.h"
 #include "opl_internal.h"
@@ -45,6 +50,10 @@ static opl_callback_queue_t *callback_queue;
 
 static uint64_t current_time;
 
+// Number of samples generated since startup.
+
+static uint64_t current_sample;
+
 // If non-zero, playback is currently paused.
 
 static int opl_sdl_paused;
@@ -72,6 +81,27 @@ static opl_timer_t timer2 = { 3125, 0, 0, 0 };
 
 static int mixing_channels;
 
+// Output of each chip for the current block, mixed afterwards.
+
+static Bit16s *chip_buffers[OPL_MAX_CHIPS];
+static int chip_buffer_samples;
+
+// Chips other than the first one are rendered by their own threads when
+// a block is long enough to be worth the synchronization.
+
+#define PARALLEL_MIN_SAMPLES 128
+
+static SDL_Thread *chip_threads[OPL_MAX_CHIPS];
+static SDL_Mutex *render_mutex;
+static SDL_Condition *render_cond;
+static SDL_Condition *done_cond;
+static unsigned int render_generation;
+static unsigned int start_generation[OPL_MAX_CHIPS];
+static int render_samples;
+static int render_chips;
+static int render_pending;
+static boolean render_quit;
+
 // Advance time by the specified number of samples, invoking any
 // callback functions as appropriate.
 
@@ -85,6 +115,7 @@ static void AdvanceTime(unsigned int nsamples)
 
     us = ((uint64_t) nsamples * OPL_SECOND) / OPL_SAMPLE_RATE;
     current_time += us;
+    current_sample += nsamples;
 
     if (opl_sdl_paused)
     {
@@ -141,6 +172,229 @@ static void ResyncChip (int chip)
 }
 
 
+// Generate a block of samples from one chip. Register writes only happen
+// between blocks, so the chip either stays active for the whole block or
+// stays idle once it times out.
+
+static void RenderChip(int c, int nsamples)
+{
+    opl3_chip *chip = &opl_chips[c];
+    Bit16s *cursor = chip_buffers[c];
+    int s = 0;
+
+    while (s < nsamples)
+    {
+        int run;
+
+        if (opl_chip_keys[c])
+        {
+            run = nsamples - s;
+        }
+        else if (opl_chip_timeouts[c] < OPL_CHIP_TIMEOUT)
+        {
+            // The timeout can't expire before this many samples.
+            run = MIN(nsamples - s, OPL_CHIP_TIMEOUT - opl_chip_timeouts[c]);
+        }
+        else if (chip->writebuf[chip->writebuf_cur].reg & 0x200)
+        {
+            // Run the chip while it has pending register writes
+            run = 1;
+        }
+        else
+        {
+            memset(cursor, 0, (nsamples - s) * 2 * sizeof(*cursor));
+            break;
+        }
+
+        OPL3_GenerateBlock(chip, cursor, run);
+
+        for (int i = 0; i < run; ++i, cursor += 2)
+        {
+            // Reset chip timeout if any channels are active
+            if (opl_chip_keys[c])
+                opl_chip_timeouts[c] = 0;
+
+            // Reset chip timeout if it breaks the silence threshold
+            if (MAX(abs(cursor[0]), abs(cursor[1])) > OPL_SILENCE_THRESHOLD)
+                opl_chip_timeouts[c] = 0;
+            else
+                opl_chip_timeouts[c]++;
+        }
+
+        s += run;
+    }
+}
+
+static int ChipThread(void *data)
+{
+    const int c = (intptr_t)data;
+    unsigned int generation = start_generation[c];
+
+    SDL_LockMutex(render_mutex);
+
+    while (true)
+    {
+        while (render_generation == generation && !render_quit)
+        {
+            SDL_WaitCondition(render_cond, render_mutex);
+        }
+
+        if (render_quit)
+        {
+            break;
+        }
+
+        generation = render_generation;
+
+        // The number of chips may have been lowered since the thread was
+        // started, such a thread isn't counted as pending.
+        if (c >= render_chips)
+        {
+            continue;
+        }
+
+        SDL_UnlockMutex(render_mutex);
+        RenderChip(c, render_samples);
+        SDL_LockMutex(render_mutex);
+
+        if (--render_pending == 0)
+        {
+            SDL_SignalCondition(done_cond);
+        }
+    }
+
+    SDL_UnlockMutex(render_mutex);
+
+    return 0;
+}
+
+static boolean StartChipThreads(void)
+{
+    if (!render_mutex)
+    {
+        render_mutex = SDL_CreateMutex();
+        render_cond = SDL_CreateCondition();
+        done_cond = SDL_CreateCondition();
+    }
+
+    if (!render_mutex || !render_cond || !done_cond)
+    {
+        return false;
+    }
+
+    for (int c = 1; c < num_opl_chips; ++c)
+    {
+        if (!chip_threads[c])
+        {
+            // Only wait for blocks started after this one.
+            start_generation[c] = render_generation;
+            chip_threads[c] = SDL_CreateThread(ChipThread, "opl chip",
+                                               (void *)(intptr_t)c);
+            if (!chip_threads[c])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void StopChipThreads(void)
+{
+    if (!render_mutex)
+    {
+        return;
+    }
+
+    SDL_LockMutex(render_mutex);
+    render_quit = true;
+    SDL_BroadcastCondition(render_cond);
+    SDL_UnlockMutex(render_mutex);
+
+    for (int c = 0; c < OPL_MAX_CHIPS; ++c)
+    {
+        if (chip_threads[c])
+        {
+            SDL_WaitThread(chip_threads[c], NULL);
+            chip_threads[c] = NULL;
+        }
+    }
+
+    render_quit = false;
+}
+
+static void RenderBlock(Bit16s *cursor, int nsamples)
+{
+    if (nsamples <= 0)
+    {
+        return;
+    }
+
+    if (nsamples > chip_buffer_samples)
+    {
+        for (int c = 0; c < OPL_MAX_CHIPS; ++c)
+        {
+            chip_buffers[c] = I_Realloc(chip_buffers[c],
+                                        nsamples * 2 * sizeof(Bit16s));
+        }
+        chip_buffer_samples = nsamples;
+    }
+
+    // Check for chip activations before we generate the first sample. Later
+    // samples can't reactivate an idle chip.
+    for (int c = 0; c < num_opl_chips; ++c)
+    {
+        // Reset chip timeout if any channels are active
+        if (opl_chip_keys[c])
+        {
+            // Resync is necessary if the chip was idle
+            if (opl_chip_timeouts[c] >= OPL_CHIP_TIMEOUT)
+                ResyncChip(c);
+            opl_chip_timeouts[c] = 0;
+        }
+    }
+
+    if (num_opl_chips > 1 && nsamples >= PARALLEL_MIN_SAMPLES
+        && StartChipThreads())
+    {
+        SDL_LockMutex(render_mutex);
+        render_samples = nsamples;
+        render_chips = num_opl_chips;
+        render_pending = num_opl_chips - 1;
+        render_generation++;
+        SDL_BroadcastCondition(render_cond);
+        SDL_UnlockMutex(render_mutex);
+
+        RenderChip(0, nsamples);
+
+        SDL_LockMutex(render_mutex);
+        while (render_pending > 0)
+        {
+            SDL_WaitCondition(done_cond, render_mutex);
+        }
+        SDL_UnlockMutex(render_mutex);
+    }
+    else
+    {
+        for (int c = 0; c < num_opl_chips; ++c)
+        {
+            RenderChip(c, nsamples);
+        }
+    }
+
+    // Mix the chips
+    for (int s = 0; s < nsamples * 2; ++s)
+    {
+        Bit32s mix = 0;
+        for (int c = 0; c < num_opl_chips; ++c)
+        {
+            mix += chip_buffers[c][s];
+        }
+        cursor[s] = CLAMP(mix, -32768, 32767);
+    }
+}
+
 // Callback function to fill a new sound buffer:
 
 int OPL_FillBuffer(byte *buffer, int buffer_samples)
@@ -178,48 +432,8 @@ int OPL_FillBuffer(byte *buffer, int buffer_samples)
         }
 
         // Add emulator output to buffer.
-        Bit16s *cursor = (Bit16s *)(buffer + filled * 4);
-        for (int s = 0; s < nsamples; ++s)
-        {
-            // Check for chip activations before we generate the sample
-            for (int c = 0; c < num_opl_chips; ++c)
-            {
-                // Reset chip timeout if any channels are active
-                if (opl_chip_keys[c])
-                {
-                    // Resync is necessary if the chip was idle
-                    if (opl_chip_timeouts[c] >= OPL_CHIP_TIMEOUT)
-                        ResyncChip(c);
-                    opl_chip_timeouts[c] = 0;
-                }
-            }
-
-            // Generate a sample from each chip and mix them
-            Bit32s mix[2] = {0, 0};
-            for (int c = 0; c < num_opl_chips; ++c)
-            {
-                // Run the chip if it's active or if it has pending register writes
-                if (opl_chip_timeouts[c] < OPL_CHIP_TIMEOUT || (opl_chips[c].writebuf[opl_chips[c].writebuf_cur].reg & 0x200))
-                {
-                    Bit16s sample[2];
-                    OPL3_Generate(&opl_chips[c], sample);
-                    mix[0] += sample[0];
-                    mix[1] += sample[1];
-
-                    // Reset chip timeout if it breaks the silence threshold
-                    if (MAX(abs(sample[0]), abs(sample[1])) > OPL_SILENCE_THRESHOLD)
-                        opl_chip_timeouts[c] = 0;
-                    else
-                        opl_chip_timeouts[c]++;
-                }
-            }
-
-            cursor[0] = CLAMP(mix[0], -32768, 32767);
-            cursor[1] = CLAMP(mix[1], -32768, 32767);
-            cursor += 2;
-        }
+        RenderBlock((Bit16s *)(buffer + filled * 4), nsamples);
 
-        //OPL3_GenerateStream(&opl_chip, (Bit16s *)(buffer + filled * 4), nsamples);
         filled += nsamples;
 
         // Invoke callbacks for this point in time.
@@ -230,10 +444,24 @@ int OPL_FillBuffer(byte *buffer, int buffer_samples)
     return buffer_samples;
 }
 
+uint64_t OPL_GetSamplePosition(void)
+{
+    return current_sample;
+}
+
 static void OPL_SDL_Shutdown(void)
 {
     OPL_Queue_Destroy(callback_queue);
 
+    StopChipThreads();
+
+    for (int c = 0; c < OPL_MAX_CHIPS; ++c)
+    {
+        free(chip_buffers[c]);
+        chip_buffers[c] = NULL;
+    }
+    chip_buffer_samples = 0;
+
 /*
     if (opl_chip != NULL)
     {
@@ -252,6 +480,7 @@ static int OPL_SDL_Init(unsigned int port_base, int num_chips)
 
     callback_queue = OPL_Queue_Create();
     current_time = 0;
+    current_sample = 0;
 
     // Get the mixer frequency, format and number of channels.
 
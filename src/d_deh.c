@@ -562,11 +562,13 @@ char *savegamename;
 // strdups to set these new values that we read from the file, orphaning
 // the original value set above.
 
-typedef struct
+typedef struct deh_strs_s
 {
     char **ppstr; // doubly indirect pointer to string
     char *lookup; // pointer to lookup string name
     const char *orig;
+    struct deh_strs_s *first_lookup, *next_lookup; // hash chains
+    struct deh_strs_s *first_orig, *next_orig;
 } deh_strs;
 
 static deh_strs deh_strlookup[] = {
@@ -1583,6 +1585,36 @@ static const deh_bexptr_t deh_bexptrs[] = {
     {{NULL}, "A_NULL"}, // Ty 05/16/98
 };
 
+// Reserve the DSDHacked states for the highest frame number in the file at
+// once, instead of growing the tables block by block. Things and sounds are
+// not reserved here, since that would also move the indices handed out by
+// dsdh_GetNewMobjInfoIndex() and dsdh_GetNewSFXIndex().
+
+static void deh_ReserveStates(DEHFILE *fpin)
+{
+    char inbuffer[DEH_BUFFERMAX];
+    char key[DEH_MAXKEYLEN];
+    int indexnum;
+    int max_state = -1;
+
+    while (deh_fgets(inbuffer, sizeof(inbuffer), fpin))
+    {
+        // "Frame" blocks and BEX [CODEPTR] lines
+        if (sscanf(inbuffer, "%31s %i", key, &indexnum) == 2
+            && indexnum > max_state && !strcasecmp(key, "Frame"))
+        {
+            max_state = indexnum;
+        }
+    }
+
+    deh_fseek(fpin, 0);
+
+    if (max_state >= 0)
+    {
+        dsdh_EnsureStatesCapacity(max_state);
+    }
+}
+
 // ====================================================================
 // ProcessDehFile
 // Purpose: Read and process a DEH or BEX file
@@ -1663,6 +1695,8 @@ void ProcessDehFile(const char *filename, char *outfilename, int lumpnum)
              filename);
     deh_log("\nLoading DEH file %s\n\n", filename);
 
+    deh_ReserveStates(filein);
+
     // loop until end of file
 
     last_block = DEH_BLOCKMAX - 1;
@@ -3035,9 +3069,10 @@ static void deh_procText(DEHFILE *fpin, char *line)
 
             // killough 10/98: but it's an array of pointers, so we must
             // use strdup unless we redeclare sprnames and change all else
-            sprnames[i] = strdup(sprnames[i]);
+            char *name = strdup(sprnames[i]);
 
-            strncpy(sprnames[i], &inbuffer[fromlen], tolen);
+            strncpy(name, &inbuffer[fromlen], tolen);
+            dsdh_SetSpriteName(i, name);
             found = true;
         }
     }
@@ -3057,7 +3092,7 @@ static void deh_procText(DEHFILE *fpin, char *line)
             deh_log("Changing name of sfx from %s to %*s\n", S_sfx[i].name,
                     usedlen, &inbuffer[fromlen]);
 
-            S_sfx[i].name = strdup(&inbuffer[fromlen]);
+            dsdh_SetSFXName(i, strdup(&inbuffer[fromlen]));
             found = true;
         }
         if (!found) // not yet
@@ -3235,65 +3270,119 @@ static void deh_procStrings(DEHFILE *fpin, char *line)
 //          fpout     -- file stream pointer for log file (DEHOUT.TXT)
 // Returns: boolean: True if string found, false if not
 //
-static boolean deh_procStringSub(char *key, char *lookfor, char *newstring)
+static unsigned deh_strhash(const char *s)
 {
-    boolean found; // loop exit flag
-    int i;         // looper
+    unsigned hash = 0;
+    while (*s)
+    {
+        hash = hash * 31 + M_ToUpper(*s++);
+    }
+    return hash % arrlen(deh_strlookup);
+}
 
-    found = false;
-    for (i = 0; i < arrlen(deh_strlookup); i++)
+// Find a string by its mnemonic or by its original value. If several strings
+// match, the first one in deh_strlookup[] is returned.
+static deh_strs *deh_FindString(const char *key, const char *lookfor)
+{
+    static boolean hash_init;
+    deh_strs *str;
+
+    if (!hash_init)
     {
-        if (deh_strlookup[i].orig == NULL)
+        hash_init = true;
+
+        // insert in reverse so that the chains are in table order
+        for (int i = arrlen(deh_strlookup) - 1; i >= 0; i--)
         {
-            deh_strlookup[i].orig = *deh_strlookup[i].ppstr;
+            deh_strs *bucket;
+
+            str = &deh_strlookup[i];
+            str->orig = *str->ppstr;
+
+            bucket = &deh_strlookup[deh_strhash(str->lookup)];
+            str->next_lookup = bucket->first_lookup;
+            bucket->first_lookup = str;
+
+            bucket = &deh_strlookup[deh_strhash(str->orig)];
+            str->next_orig = bucket->first_orig;
+            bucket->first_orig = str;
         }
-        found = lookfor ? !strcasecmp(deh_strlookup[i].orig, lookfor)
-                        : !strcasecmp(deh_strlookup[i].lookup, key);
+    }
 
-        if (found)
+    if (lookfor)
+    {
+        for (str = deh_strlookup[deh_strhash(lookfor)].first_orig; str;
+             str = str->next_orig)
         {
-            *deh_strlookup[i].ppstr = strdup(newstring); // orphan originalstring
-            found = true;
-            // Handle embedded \n's in the incoming string, convert to 0x0a's
+            if (!strcasecmp(str->orig, lookfor))
             {
-                char *s, *t;
-                for (s = t = *deh_strlookup[i].ppstr; *s; ++s, ++t)
-                {
-                    if (*s == '\\' && (s[1] == 'n' || s[1] == 'N')) // found one
-                    {
-                        ++s, *t = '\n'; // skip one extra for second character
-                    }
-                    else
-                    {
-                        *t = *s;
-                    }
-                }
-                *t = '\0'; // cap off the target string
+                return str;
             }
-
-            if (key)
+        }
+    }
+    else
+    {
+        for (str = deh_strlookup[deh_strhash(key)].first_lookup; str;
+             str = str->next_lookup)
+        {
+            if (!strcasecmp(str->lookup, key))
             {
-                deh_log("Assigned key %s => '%s'\n", key, newstring);
+                return str;
             }
+        }
+    }
 
-            if (!key)
-            {
-                deh_log("Assigned '%.12s%s' to'%.12s%s' at key %s\n",
-                        lookfor ? lookfor : "",
-                        (lookfor && strlen(lookfor) > 12)
-                            ? "..."
-                            : "", // [FG] NULL dereference
-                        newstring, (strlen(newstring) > 12) ? "..." : "",
-                        deh_strlookup[i].lookup);
-            }
+    return NULL;
+}
+
+static boolean deh_procStringSub(char *key, char *lookfor, char *newstring)
+{
+    boolean found;
+    int i; // looper
 
-            if (!key) // must have passed an old style string so showBEX
+    deh_strs *str = deh_FindString(key, lookfor);
+
+    found = str != NULL;
+    if (found)
+    {
+        *str->ppstr = strdup(newstring); // orphan originalstring
+        // Handle embedded \n's in the incoming string, convert to 0x0a's
+        {
+            char *s, *t;
+            for (s = t = *str->ppstr; *s; ++s, ++t)
             {
-                deh_log("*BEX FORMAT:\n%s=%s\n*END BEX\n",
-                        deh_strlookup[i].lookup, dehReformatStr(newstring));
+                if (*s == '\\' && (s[1] == 'n' || s[1] == 'N')) // found one
+                {
+                    ++s, *t = '\n'; // skip one extra for second character
+                }
+                else
+                {
+                    *t = *s;
+                }
             }
+            *t = '\0'; // cap off the target string
+        }
 
-            break;
+        if (key)
+        {
+            deh_log("Assigned key %s => '%s'\n", key, newstring);
+        }
+
+        if (!key)
+        {
+            deh_log("Assigned '%.12s%s' to'%.12s%s' at key %s\n",
+                    lookfor ? lookfor : "",
+                    (lookfor && strlen(lookfor) > 12)
+                        ? "..."
+                        : "", // [FG] NULL dereference
+                    newstring, (strlen(newstring) > 12) ? "..." : "",
+                    str->lookup);
+        }
+
+        if (!key) // must have passed an old style string so showBEX
+        {
+            deh_log("*BEX FORMAT:\n%s=%s\n*END BEX\n",
+                    str->lookup, dehReformatStr(newstring));
         }
     }
 
@@ -3397,7 +3486,7 @@ static void deh_procBexSprites(DEHFILE *fpin, char *line)
         if (match >= 0)
         {
             deh_log("Substituting '%s' for sprite '%s'\n", candidate, key);
-            sprnames[match] = strdup(candidate);
+            dsdh_SetSpriteName(match, strdup(candidate));
         }
     }
 }
@@ -3451,7 +3540,7 @@ static void deh_procBexSounds(DEHFILE *fpin, char *line)
         if (match >= 0)
         {
             deh_log("Substituting '%s' for sound '%s'\n", candidate, key);
-            S_sfx[match].name = strdup(candidate);
+            dsdh_SetSFXName(match, strdup(candidate));
         }
     }
 }
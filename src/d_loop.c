@@ -138,8 +138,13 @@ static boolean BuildNewTic(void)
 
     gameticdiv = gametic / ticdup;
 
-    I_StartTic();
-    D_ProcessEvents();
+    // Without display, polling events costs more than a tic of the game
+    // simulation, so only do it once per second.
+    if (!headless || !(maketic % TICRATE))
+    {
+        I_StartTic();
+        D_ProcessEvents();
+    }
 
     // Always run the menu
 
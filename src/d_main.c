@@ -44,6 +44,7 @@
 #include "f_finale.h"
 #include "f_wipe.h"
 #include "g_compatibility.h"
+#include "g_demostream.h"
 #include "g_game.h"
 #include "i_endoom.h"
 #include "i_glob.h"
@@ -62,7 +63,9 @@
 #include "m_io.h"
 #include "mn_menu.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "m_swap.h"
+#include "m_tasks.h"
 #include "net_client.h"
 #include "net_dedicated.h"
 #include "p_ambient.h"
@@ -1843,6 +1846,8 @@ void D_DoomMain(void)
 
   FindResponseFile();         // Append response file arguments to command-line
 
+  M_InitProfile();
+
   //!
   // @category net
   //
@@ -1859,11 +1864,28 @@ void D_DoomMain(void)
       // Never returns
   }
 
+  //!
+  // @arg <demo>
+  // @category demo
+  //
+  // Terminate a demo whose recording was interrupted by a crash, dropping any
+  // partially written tic.
+  //
+
+  p = M_CheckParmWithArgs("-recoverdemo", 1);
+  if (p)
+  {
+      G_RecoverDemo(myargv[p + 1]);
+      I_SafeExit(0);
+  }
+
   // killough 10/98: set default savename based on executable's name
   sprintf(savegamename = malloc(16), "%.4ssav", D_DoomExeName());
 
   I_Printf(VB_INFO, "W_Init: Init WADfiles.");
 
+  M_BeginProfile("IdentifyVersion");
+
   LoadBaseFile();
 
   IdentifyVersion();
@@ -1891,6 +1913,8 @@ void D_DoomMain(void)
 
   D_InitTables();
 
+  M_EndProfile();
+
   modifiedgame = false;
 
   // killough 7/19/98: beta emulation option
@@ -2069,6 +2093,8 @@ void D_DoomMain(void)
 
   // add wad files from autoload IWAD directories before wads from -file parameter
 
+  M_BeginProfile("Collect WAD files");
+
   LoadIWadBase();
   PrepareAutoloadPaths();
   AutoloadIWadDir(AutoLoadWADs);
@@ -2107,6 +2133,8 @@ void D_DoomMain(void)
   LoadPWadBase();
   AutoloadPWadDir(AutoLoadWADs);
 
+  M_EndProfile();
+
   // get skill / episode / map from parms
 
   startskill = sk_default; // jff 3/24/98 was sk_medium, just note not picked
@@ -2301,11 +2329,22 @@ void D_DoomMain(void)
 
   noblit = M_CheckParm ("-noblit");
 
+  // Timing a demo without display, run only the game simulation.
+  headless = nodrawers
+             && (M_ParmExists("-fastdemo") || M_ParmExists("-timedemo"));
+  if (headless)
+  {
+    nomusicparm = true;
+    nosfxparm = true;
+  }
+
   M_InitConfig();
 
   I_PutChar(VB_INFO, '\n');
 
+  M_BeginProfile("M_LoadDefaults");
   M_LoadDefaults();  // load before initing other systems
+  M_EndProfile();
 
   bodyquesize = default_bodyquesize; // killough 10/98
 
@@ -2313,13 +2352,17 @@ void D_DoomMain(void)
 
   // init subsystems
 
+  M_BeginProfile("W_InitMultipleFiles");
   W_InitMultipleFiles();
+  M_EndProfile();
 
   // Check for wolf levels
   haswolflevels = (W_CheckNumForName("map31") >= 0);
 
   // process deh in IWAD
 
+  M_BeginProfile("DEHACKED");
+
   //!
   // @category mod
   //
@@ -2349,7 +2392,11 @@ void D_DoomMain(void)
 
   PostProcessDeh();
 
+  M_EndProfile();
+
+  M_BeginProfile("BRGHTMPS");
   W_ProcessInWads("BRGHTMPS", R_ParseBrightmaps, PROCESS_PWAD);
+  M_EndProfile();
 
   // Moved after WAD initialization because we are checking the COMPLVL lump
   G_ReloadDefaults(false); // killough 3/4/98: set defaults just loaded.
@@ -2384,16 +2431,22 @@ void D_DoomMain(void)
   // Disable UMAPINFO loading.
   //
 
+  M_BeginProfile("UMAPINFO");
   if (!M_ParmExists("-nomapinfo"))
   {
     W_ProcessInWads("UMAPINFO", G_ParseMapInfo, PROCESS_IWAD | PROCESS_PWAD);
   }
+  M_EndProfile();
 
+  M_BeginProfile("G_ParseCompDatabase");
   G_ParseCompDatabase();
+  M_EndProfile();
 
   D_SetSavegameDirectory();
 
+  M_BeginProfile("V_InitColorTranslation");
   V_InitColorTranslation(); //jff 4/24/98 load color translation lumps
+  M_EndProfile();
 
   // killough 2/22/98: copyright / "modified game" / SPA banners removed
 
@@ -2428,25 +2481,39 @@ void D_DoomMain(void)
   // Allows PWAD HELP2 screen for DOOM 1 wads (using Ultimate Doom IWAD).
   pwad_help2 = gamemode == retail && W_IsWADLump(W_CheckNumForName("HELP2"));
 
+  M_BeginProfile("SNDINFO/TRAKINFO");
   W_ProcessInWads("SNDINFO", S_ParseSndInfo, PROCESS_IWAD | PROCESS_PWAD);
 
   W_ProcessInWads("TRAKINFO", S_ParseTrakInfo, PROCESS_IWAD | PROCESS_PWAD);
+  M_EndProfile();
   D_SetupDemoLoop();
 
   I_Printf(VB_INFO, "M_Init: Init miscellaneous info.");
+  M_BeginProfile("M_Init");
   M_Init();
+  M_EndProfile();
 
   I_Printf(VB_INFO, "R_Init: Init DOOM refresh daemon - ");
+  M_BeginProfile("R_Init");
   R_Init();
+  M_EndProfile();
 
   I_Printf(VB_INFO, "P_Init: Init Playloop state.");
+  M_BeginProfile("P_Init");
   P_Init();
+  M_EndProfile();
 
   I_Printf(VB_INFO, "I_Init: Setting up machine state.");
   I_InitTimer();
   I_InitGamepad();
+  M_BeginProfile("I_InitSound");
   I_InitSound();
+  M_EndProfile();
+  M_BeginProfile("I_InitMusic");
   I_InitMusic();
+  M_EndProfile();
+
+  M_BeginProfile("NET_Init");
 
   I_Printf(VB_INFO, "NET_Init: Init network subsystem.");
   NET_Init();
@@ -2457,6 +2524,8 @@ void D_DoomMain(void)
   I_Printf(VB_INFO, "D_CheckNetGame: Checking network game status.");
   D_CheckNetGame();
 
+  M_EndProfile();
+
   G_UpdateSideMove();
   G_UpdateAngleFunctions();
   G_UpdateLocalViewFunction();
@@ -2468,17 +2537,23 @@ void D_DoomMain(void)
   G_SetTimeScale();
 
   I_Printf(VB_INFO, "S_Init: Setting up sound.");
+  M_BeginProfile("S_Init");
   S_Init(snd_SfxVolume /* *8 */, snd_MusicVolume /* *8*/ );
+  M_EndProfile();
 
   I_Printf(VB_INFO, "HU_Init: Setting up heads up display.");
 
   I_Printf(VB_INFO, "ST_Init: Init status bar.");
+  M_BeginProfile("ST_Init");
   ST_Init();
   MN_SetHUFontKerning();
+  M_EndProfile();
 
   // andrewj: voxel support
   I_Printf(VB_INFO, "VX_Init: ");
+  M_BeginProfile("VX_Init");
   VX_Init();
+  M_EndProfile();
 
   I_PutChar(VB_INFO, '\n');
 
@@ -2638,12 +2713,21 @@ void D_DoomMain(void)
   }
 
   // [FG] init graphics (video.widedelta) before HUD widgets
+  M_BeginProfile("I_InitGraphics");
   I_InitGraphics();
+  M_EndProfile();
   I_InitKeyboard();
 
   MN_InitMenuStrings();
   MN_InitFreeLook();
 
+  // Tables composed by worker threads during startup are complete now.
+  M_BeginProfile("M_WaitTasks");
+  M_WaitTasks();
+  M_EndProfile();
+
+  M_BeginProfile("Start game");
+
   // Auto save slot is 255 for -loadgame command.
   if (startloadgame == 255 && !demorecording && gameaction != ga_playdemo
       && !netgame)
@@ -2673,6 +2757,10 @@ void D_DoomMain(void)
 	D_StartTitle();                 // start up intro loop
     }
 
+  M_EndProfile();
+
+  M_FinishProfile();
+
   // killough 12/98: inlined D_DoomLoop
 
   if (!demorecording)
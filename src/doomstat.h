@@ -259,6 +259,7 @@ extern  boolean menuactive;    // Menu overlayed?
 extern  int     paused;        // Game Pause?
 extern  boolean viewactive;
 extern  boolean nodrawers;
+extern  boolean headless;
 extern  boolean noblit;
 extern  boolean nosfxparm;
 extern  boolean nomusicparm;
@@ -22,6 +22,108 @@
 #include "doomtype.h"
 #include "info.h"
 #include "m_array.h"
+#include "m_misc.h"
+
+//
+//   Name indexes
+//
+// Chained hash tables from names to table indices. Renamed entries are added
+// again under the new name and stale entries are left in place, so lookups
+// must compare the current name of every candidate.
+
+typedef struct
+{
+    unsigned hash;
+    int index;
+    int next;
+} namenode_t;
+
+typedef struct
+{
+    int *buckets;
+    int numbuckets; // power of two
+    namenode_t *nodes;
+    int length; // number of significant characters
+} nameindex_t;
+
+static unsigned HashName(const char *name, int length)
+{
+    unsigned hash = 0;
+
+    for (int i = 0; i < length && name[i]; ++i)
+    {
+        hash = hash * 31 + M_ToUpper(name[i]);
+    }
+
+    return hash;
+}
+
+static void RehashNames(nameindex_t *nameindex, int numbuckets)
+{
+    nameindex->numbuckets = numbuckets;
+    nameindex->buckets = realloc(nameindex->buckets,
+                                 numbuckets * sizeof(*nameindex->buckets));
+    for (int i = 0; i < numbuckets; ++i)
+    {
+        nameindex->buckets[i] = -1;
+    }
+
+    for (int i = 0; i < array_size(nameindex->nodes); ++i)
+    {
+        namenode_t *node = &nameindex->nodes[i];
+        int *bucket = &nameindex->buckets[node->hash & (numbuckets - 1)];
+        node->next = *bucket;
+        *bucket = i;
+    }
+}
+
+static void AddName(nameindex_t *nameindex, const char *name, int index)
+{
+    if (!name)
+    {
+        return;
+    }
+
+    if (array_size(nameindex->nodes) >= nameindex->numbuckets)
+    {
+        RehashNames(nameindex, nameindex->numbuckets * 2);
+    }
+
+    namenode_t node = {HashName(name, nameindex->length), index, -1};
+    int *bucket = &nameindex->buckets[node.hash & (nameindex->numbuckets - 1)];
+    node.next = *bucket;
+    *bucket = array_size(nameindex->nodes);
+    array_push(nameindex->nodes, node);
+}
+
+static void InitNameIndex(nameindex_t *nameindex, int length, int count)
+{
+    int numbuckets = 256;
+    while (numbuckets < count)
+    {
+        numbuckets *= 2;
+    }
+
+    nameindex->length = length;
+    array_grow(nameindex->nodes, count);
+    RehashNames(nameindex, numbuckets);
+}
+
+static void FreeNameIndex(nameindex_t *nameindex)
+{
+    free(nameindex->buckets);
+    array_free(nameindex->nodes);
+    memset(nameindex, 0, sizeof(*nameindex));
+}
+
+// First node that may hold the first length characters of the key, continue
+// with node->next.
+static int FirstName(const nameindex_t *nameindex, const char *key,
+                     int length)
+{
+    const unsigned hash = HashName(key, MIN(length, nameindex->length));
+    return nameindex->buckets[hash & (nameindex->numbuckets - 1)];
+}
 
 //
 //   States
@@ -110,16 +212,22 @@ char **sprnames = NULL;
 int num_sprites;
 static char **deh_spritenames = NULL;
 static byte *sprnames_state = NULL;
+static nameindex_t sprite_index, original_sprite_index;
 
 static void InitSprites(void)
 {
     sprnames = original_sprnames;
     num_sprites = NUMSPRITES;
 
+    InitNameIndex(&sprite_index, 4, num_sprites);
+    InitNameIndex(&original_sprite_index, 4, num_sprites);
+
     array_grow(deh_spritenames, num_sprites);
     for (int i = 0; i < num_sprites; i++)
     {
         deh_spritenames[i] = strdup(sprnames[i]);
+        AddName(&sprite_index, sprnames[i], i);
+        AddName(&original_sprite_index, deh_spritenames[i], i);
     }
 
     array_grow(sprnames_state, num_sprites);
@@ -169,36 +277,61 @@ static void FreeSprites(void)
     }
     array_free(deh_spritenames);
     array_free(sprnames_state);
+    FreeNameIndex(&sprite_index);
+    FreeNameIndex(&original_sprite_index);
+}
+
+void dsdh_SetSpriteName(int index, char *name)
+{
+    sprnames[index] = name;
+    AddName(&sprite_index, name, index);
 }
 
 int dsdh_GetDehSpriteIndex(const char *key)
 {
-    for (int i = 0; i < num_sprites; ++i)
+    int result = -1;
+
+    for (int n = FirstName(&sprite_index, key, 4); n >= 0;
+         n = sprite_index.nodes[n].next)
     {
-        if (sprnames[i] && !strncasecmp(sprnames[i], key, 4)
-            && !sprnames_state[i])
+        const int i = sprite_index.nodes[n].index;
+
+        if ((result < 0 || i < result) && sprnames[i]
+            && !strncasecmp(sprnames[i], key, 4) && !sprnames_state[i])
         {
-            sprnames_state[i] = true; // sprite has been edited
-            return i;
+            result = i;
         }
     }
 
-    return -1;
+    if (result >= 0)
+    {
+        sprnames_state[result] = true; // sprite has been edited
+    }
+
+    return result;
 }
 
 int dsdh_GetOriginalSpriteIndex(const char *key)
 {
-    int i;
+    int i = -1;
     const char *c;
 
-    for (i = 0; i < array_capacity(deh_spritenames); ++i)
+    for (int n = FirstName(&original_sprite_index, key, 4); n >= 0;
+         n = original_sprite_index.nodes[n].next)
     {
-        if (deh_spritenames[i] && !strncasecmp(deh_spritenames[i], key, 4))
+        const int j = original_sprite_index.nodes[n].index;
+
+        if ((i < 0 || j < i) && !strncasecmp(deh_spritenames[j], key, 4))
         {
-            return i;
+            i = j;
         }
     }
 
+    if (i >= 0)
+    {
+        return i;
+    }
+
     // is it a number?
     for (c = key; *c; c++)
     {
@@ -224,6 +357,7 @@ int num_sfx;
 static int sfx_index;
 static char **deh_soundnames = NULL;
 static byte *sfx_state = NULL;
+static nameindex_t sfx_name_index, original_sfx_name_index;
 
 static void InitSFX(void)
 {
@@ -231,10 +365,15 @@ static void InitSFX(void)
     num_sfx = NUMSFX;
     sfx_index = NUMSFX - 1;
 
+    InitNameIndex(&sfx_name_index, 8, num_sfx);
+    InitNameIndex(&original_sfx_name_index, 6, num_sfx);
+
     array_grow(deh_soundnames, num_sfx);
     for (int i = 1; i < num_sfx; i++)
     {
         deh_soundnames[i] = S_sfx[i].name ? strdup(S_sfx[i].name) : NULL;
+        AddName(&sfx_name_index, S_sfx[i].name, i);
+        AddName(&original_sfx_name_index, deh_soundnames[i], i);
     }
 
     array_grow(sfx_state, num_sfx);
@@ -252,6 +391,8 @@ static void FreeSFX(void)
     }
     array_free(deh_soundnames);
     array_free(sfx_state);
+    FreeNameIndex(&sfx_name_index);
+    FreeNameIndex(&original_sfx_name_index);
 }
 
 void dsdh_EnsureSFXCapacity(int limit)
@@ -298,34 +439,58 @@ void dsdh_EnsureSFXCapacity(int limit)
     }
 }
 
+void dsdh_SetSFXName(int index, char *name)
+{
+    S_sfx[index].name = name;
+    AddName(&sfx_name_index, name, index);
+}
+
 int dsdh_GetDehSFXIndex(const char *key, size_t length)
 {
-    for (int i = 1; i < num_sfx; ++i)
+    int result = -1;
+
+    for (int n = FirstName(&sfx_name_index, key, length); n >= 0;
+         n = sfx_name_index.nodes[n].next)
     {
-        if (S_sfx[i].name && strlen(S_sfx[i].name) == length
+        const int i = sfx_name_index.nodes[n].index;
+
+        if ((result < 0 || i < result) && S_sfx[i].name
+            && strlen(S_sfx[i].name) == length
             && !strncasecmp(S_sfx[i].name, key, length) && !sfx_state[i])
         {
-            sfx_state[i] = true; // sfx has been edited
-            return i;
+            result = i;
         }
     }
 
-    return -1;
+    if (result >= 0)
+    {
+        sfx_state[result] = true; // sfx has been edited
+    }
+
+    return result;
 }
 
 int dsdh_GetOriginalSFXIndex(const char *key)
 {
-    int i;
+    int i = -1;
     const char *c;
 
-    for (i = 1; i < array_capacity(deh_soundnames); ++i)
+    for (int n = FirstName(&original_sfx_name_index, key, 6); n >= 0;
+         n = original_sfx_name_index.nodes[n].next)
     {
-        if (deh_soundnames[i] && !strncasecmp(deh_soundnames[i], key, 6))
+        const int j = original_sfx_name_index.nodes[n].index;
+
+        if ((i < 0 || j < i) && !strncasecmp(deh_soundnames[j], key, 6))
         {
-            return i;
+            i = j;
         }
     }
 
+    if (i >= 0)
+    {
+        return i;
+    }
+
     // is it a number?
     for (c = key; *c; c++)
     {
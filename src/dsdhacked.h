@@ -26,6 +26,8 @@ void dsdh_FreeTables(void);
 void dsdh_EnsureStatesCapacity(int limit);
 void dsdh_EnsureSFXCapacity(int limit);
 void dsdh_EnsureMobjInfoCapacity(int limit);
+void dsdh_SetSpriteName(int index, char *name);
+void dsdh_SetSFXName(int index, char *name);
 int dsdh_GetDehSpriteIndex(const char *key);
 int dsdh_GetOriginalSpriteIndex(const char *key);
 int dsdh_GetDehSFXIndex(const char *key, size_t length);
@@ -0,0 +1,357 @@
+//
+// Copyright(C) 2025 Roman Fomin
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+#include "g_demostream.h"
+
+#include <SDL3/SDL.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "doomdef.h"
+#include "doomstat.h"
+#include "doomtype.h"
+#include "g_game.h"
+#include "i_printf.h"
+#include "i_system.h"
+#include "m_array.h"
+#include "m_io.h"
+#include "m_misc.h"
+#include "z_zone.h"
+
+// Interval between flushes of the file to disk.
+#define SYNC_INTERVAL 5000 // [ms]
+
+typedef struct
+{
+    byte *data;
+    size_t offset;
+    size_t length;
+    boolean final;
+} chunk_t;
+
+static SDL_Thread *stream_thread;
+static SDL_Mutex *stream_mutex;
+static SDL_Condition *stream_cond;
+static chunk_t *stream_queue;
+
+static FILE *stream_file;
+static boolean stream_failed;
+static int stream_error; // written by the writer thread only
+static uint64_t stream_synctime;
+
+static boolean SyncFile(FILE *file)
+{
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+static boolean TruncateFile(FILE *file, size_t length)
+{
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), length) == 0;
+#else
+    return ftruncate(fileno(file), length) == 0;
+#endif
+}
+
+static boolean WriteChunk(const chunk_t *chunk)
+{
+    static const byte marker = DEMOMARKER;
+
+    errno = 0;
+
+    if (fseek(stream_file, (long)chunk->offset, SEEK_SET)
+        || fwrite(chunk->data, 1, chunk->length, stream_file) != chunk->length)
+    {
+        return false;
+    }
+
+    // Terminate the demo after every write, the next write overwrites the
+    // marker.
+    if (!chunk->final && fwrite(&marker, 1, 1, stream_file) != 1)
+    {
+        return false;
+    }
+
+    if (fflush(stream_file))
+    {
+        return false;
+    }
+
+    if (chunk->final)
+    {
+        // Remove the tics left behind by rewinding.
+        return TruncateFile(stream_file, chunk->offset + chunk->length)
+               && SyncFile(stream_file);
+    }
+
+    const uint64_t time = SDL_GetTicks();
+    if (time - stream_synctime >= SYNC_INTERVAL)
+    {
+        stream_synctime = time;
+        return SyncFile(stream_file);
+    }
+
+    return true;
+}
+
+static void ProcessChunk(chunk_t *chunk)
+{
+    if (!stream_error && !WriteChunk(chunk))
+    {
+        stream_error = errno ? errno : EIO;
+    }
+    free(chunk->data);
+}
+
+static int StreamThread(void *unused)
+{
+    boolean final = false;
+
+    while (!final)
+    {
+        SDL_LockMutex(stream_mutex);
+        while (array_size(stream_queue) == 0)
+        {
+            SDL_WaitCondition(stream_cond, stream_mutex);
+        }
+
+        chunk_t chunk = stream_queue[0];
+        array_delete(stream_queue, 0);
+
+        SDL_UnlockMutex(stream_mutex);
+
+        final = chunk.final;
+        ProcessChunk(&chunk);
+    }
+
+    return 0;
+}
+
+static void QueueChunk(const byte *data, size_t offset, size_t length,
+                       boolean final)
+{
+    chunk_t chunk = {malloc(length), offset, length, final};
+    memcpy(chunk.data, data, length);
+
+    if (!stream_thread)
+    {
+        ProcessChunk(&chunk);
+        return;
+    }
+
+    SDL_LockMutex(stream_mutex);
+    array_push(stream_queue, chunk);
+    SDL_SignalCondition(stream_cond);
+    SDL_UnlockMutex(stream_mutex);
+}
+
+static boolean OpenStream(const char *name)
+{
+    stream_file = M_fopen(name, "wb");
+
+    if (!stream_file)
+    {
+        I_Printf(VB_WARNING, "G_WriteDemoStream: Couldn't open %s: %s", name,
+                 strerror(errno));
+        stream_failed = true;
+        return false;
+    }
+
+    stream_error = 0;
+    stream_synctime = SDL_GetTicks();
+
+    if (!stream_mutex)
+    {
+        stream_mutex = SDL_CreateMutex();
+        stream_cond = SDL_CreateCondition();
+    }
+
+    if (stream_mutex && stream_cond)
+    {
+        stream_thread = SDL_CreateThread(StreamThread, "demo writer", NULL);
+    }
+
+    return true;
+}
+
+void G_WriteDemoStream(const char *name, const byte *data, size_t offset,
+                       size_t length)
+{
+    if (stream_failed || (!stream_file && !OpenStream(name)))
+    {
+        return;
+    }
+
+    QueueChunk(data, offset, length, false);
+}
+
+boolean G_CloseDemoStream(const byte *data, size_t offset, size_t length)
+{
+    if (!stream_file)
+    {
+        stream_failed = false;
+        return false;
+    }
+
+    QueueChunk(data, offset, length, true);
+
+    if (stream_thread)
+    {
+        SDL_WaitThread(stream_thread, NULL);
+        stream_thread = NULL;
+    }
+
+    if (fclose(stream_file) && !stream_error)
+    {
+        stream_error = errno ? errno : EIO;
+    }
+    stream_file = NULL;
+
+    if (stream_error)
+    {
+        I_Printf(VB_WARNING, "G_CloseDemoStream: %s", strerror(stream_error));
+        errno = stream_error;
+        return false;
+    }
+
+    return true;
+}
+
+// Size of the header of the demo formats that we record.
+
+static int DemoHeaderSize(const byte *data, int length, int *numplayers,
+                          int *ticsize)
+{
+    int size, ingame;
+
+    if (length < 1)
+    {
+        return -1;
+    }
+
+    switch (data[0])
+    {
+        case DV_VANILLA:
+        case DV_LONGTIC:
+            // version, skill, episode, map, deathmatch, respawn, fast,
+            // nomonsters, consoleplayer
+            ingame = 9;
+            size = ingame + 4;
+            *ticsize = data[0] == DV_LONGTIC ? 5 : 4;
+            break;
+
+        case DV_BOOM:
+        case DV_MBF:
+            // version, signature, compatibility, skill, episode, map,
+            // deathmatch, consoleplayer, options
+            ingame = 1 + 6 + 1 + 5 + GAME_OPTION_SIZE;
+            size = ingame + MIN_MAXPLAYERS;
+            *ticsize = 4;
+            break;
+
+        case DV_MBF21:
+            // the number of comp options is stored in the demo
+            ingame = 1 + 6 + 5 + 20;
+            if (ingame >= length)
+            {
+                return -1;
+            }
+            ingame += 1 + data[ingame];
+            size = ingame + MIN_MAXPLAYERS;
+            *ticsize = 5;
+            break;
+
+        default:
+            return -1;
+    }
+
+    if (size > length)
+    {
+        return -1;
+    }
+
+    *numplayers = 0;
+    for (int i = 0; i < MAXPLAYERS; ++i)
+    {
+        if (data[ingame + i])
+        {
+            ++*numplayers;
+        }
+    }
+
+    return *numplayers ? size : -1;
+}
+
+void G_RecoverDemo(const char *name)
+{
+    byte *buffer;
+    int length = M_ReadFile(name, &buffer);
+    int numplayers, ticsize;
+
+    int pos = DemoHeaderSize(buffer, length, &numplayers, &ticsize);
+    if (pos < 0)
+    {
+        I_Error("G_RecoverDemo: %s is not a supported demo", name);
+    }
+
+    const int ticlength = numplayers * ticsize;
+    int tics = 0;
+
+    while (pos + ticlength <= length && buffer[pos] != DEMOMARKER)
+    {
+        pos += ticlength;
+        ++tics;
+    }
+
+    if (pos < length && buffer[pos] == DEMOMARKER)
+    {
+        I_Printf(VB_ALWAYS, "G_RecoverDemo: %s is complete (%d tics)", name,
+                 tics);
+        Z_Free(buffer);
+        return;
+    }
+
+    // drop the partially written tic and terminate the demo
+    buffer = Z_Realloc(buffer, pos + 1, PU_STATIC, NULL);
+    buffer[pos++] = DEMOMARKER;
+
+    char *tmpname = M_StringJoin(name, ".tmp");
+
+    if (!M_WriteFile(tmpname, buffer, pos))
+    {
+        I_Error("G_RecoverDemo: Couldn't write %s: %s", tmpname,
+                errno ? strerror(errno) : "(Unknown Error)");
+    }
+
+    if (M_rename(tmpname, name))
+    {
+        M_remove(name);
+        if (M_rename(tmpname, name))
+        {
+            I_Error("G_RecoverDemo: Couldn't rename %s: %s", tmpname,
+                    strerror(errno));
+        }
+    }
+
+    free(tmpname);
+    Z_Free(buffer);
+
+    I_Printf(VB_ALWAYS, "G_RecoverDemo: %s recovered (%d tics)", name, tics);
+}
@@ -0,0 +1,35 @@
+//
+// Copyright(C) 2025 Roman Fomin
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+#ifndef G_DEMOSTREAM_H
+#define G_DEMOSTREAM_H
+
+#include <stddef.h>
+
+#include "doomtype.h"
+
+// Queue the bytes [offset, offset + length) of the demo buffer for writing.
+// Each write is followed by an end marker so that the file on disk is always
+// a playable demo.
+void G_WriteDemoStream(const char *name, const byte *data, size_t offset,
+                       size_t length);
+
+// Write the final bytes (end marker and footer included), truncate the file
+// and wait for the writer. Returns false if the stream failed, in which case
+// the caller should write the whole demo buffer itself.
+boolean G_CloseDemoStream(const byte *data, size_t offset, size_t length);
+
+// Terminate a demo that was cut short by a crash.
+void G_RecoverDemo(const char *name);
+
+#endif
@@ -16,6 +16,8 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <SDL3/SDL.h>
+
 #include <errno.h>
 #include <math.h>
 #include <stdarg.h>
@@ -40,6 +42,7 @@
 #include "doomstat.h"
 #include "doomtype.h"
 #include "f_finale.h"
+#include "g_demostream.h"
 #include "g_game.h"
 #include "g_rewind.h"
 #include "g_nextweapon.h"
@@ -64,6 +67,7 @@
 #include "m_random.h"
 #include "m_swap.h" // [FG] LONG
 #include "memio.h"
+#include "miniz.h"
 #include "mn_menu.h"
 #include "mn_snapshot.h"
 #include "net_defs.h"
@@ -133,6 +137,7 @@ boolean         timingdemo;    // if true, exit with report on completion
 boolean         fastdemo;      // if true, run at full speed -- killough
 boolean         nodrawers;     // for comparative timing purposes
 boolean         noblit;        // for comparative timing purposes
+boolean         headless;      // run only the game simulation
 int             starttime;     // for comparative timing purposes
 boolean         viewactive;
 int             deathmatch;    // only if started as net death
@@ -268,17 +273,19 @@ static weapontype_t WeaponSSG(void)
 // [FG] toggle demo warp mode
 void G_EnableWarp(boolean warp)
 {
-  static boolean nodrawers_old;
+  static boolean nodrawers_old, headless_old;
   static boolean nomusicparm_old, nosfxparm_old;
 
   if (warp)
   {
     nodrawers_old = nodrawers;
+    headless_old = headless;
     nomusicparm_old = nomusicparm;
     nosfxparm_old = nosfxparm;
 
     I_SetFastdemoTimer(true);
     nodrawers = true;
+    headless = true;
     nomusicparm = true;
     nosfxparm = true;
   }
@@ -286,6 +293,7 @@ void G_EnableWarp(boolean warp)
   {
     I_SetFastdemoTimer(false);
     nodrawers = nodrawers_old;
+    headless = headless_old;
     nomusicparm = nomusicparm_old;
     nosfxparm = nosfxparm_old;
   }
@@ -319,6 +327,7 @@ static void G_DemoSkipTics(void)
     if (playback_skiptics < curtic)
     {
       playback_skiptics = 0;
+      warp = false; // later seeks use absolute tics
       G_EnableWarp(false);
       S_RestartMusic();
     }
@@ -1508,8 +1517,6 @@ int playback_tic = 0, playback_totaltics = 0;
 
 static const char *defdemoname;
 
-#define DEMOMARKER    0x80
-
 // Stay in the game, hand over controls to the player and continue recording the
 // demo under a different name
 static void G_JoinDemo(void)
@@ -1580,7 +1587,8 @@ static void CheckDemoBuffer(size_t size)
   ptrdiff_t position = demo_p - demobuffer;
   if (position + size > maxdemosize)
   {
-    maxdemosize += size + 128 * 1024; // add another 128K
+    // grow geometrically, every reallocation copies the whole buffer
+    maxdemosize = MAX(maxdemosize * 2, (size_t)position + size);
     demobuffer = Z_Realloc(demobuffer, maxdemosize, PU_STATIC, 0);
     demo_p = position + demobuffer;
   }
@@ -1588,11 +1596,30 @@ static void CheckDemoBuffer(size_t size)
 
 // Demo limits removed -- killough
 
+// Offset of the first byte of the demo buffer not yet sent to the demo file.
+static size_t demo_streampos;
+
+// Send newly recorded tics to the demo file.
+static void G_StreamDemo(void)
+{
+  size_t position = demo_p - demobuffer;
+
+  if (position > demo_streampos)
+  {
+    G_WriteDemoStream(demoname, demobuffer + demo_streampos, demo_streampos,
+                      position - demo_streampos);
+    demo_streampos = position;
+  }
+}
+
 static void G_WriteDemoTiccmd(ticcmd_t* cmd)
 {
   if (M_InputGameActive(input_demo_quit)) // press to end demo recording
     G_CheckDemoStatus();
 
+  // rewound or restarted, overwrite the demo file from here
+  demo_streampos = MIN(demo_streampos, (size_t)(demo_p - demobuffer));
+
   demo_p[0] = cmd->forwardmove;
   demo_p[1] = cmd->sidemove;
   if (!longtics)
@@ -1977,13 +2004,6 @@ static void G_DoWorldDone(void)
   }
 }
 
-// killough 2/28/98: A ridiculously large number
-// of players, the most you'll ever need in a demo
-// or savegame. This is used to prevent problems, in
-// case more players in a game are supported later.
-
-#define MIN_MAXPLAYERS 32
-
 static void InvalidDemo(void)
 {
     gameaction = ga_nothing;
@@ -2451,6 +2471,229 @@ static uint64_t G_Signature(int sig_epi, int sig_map)
   return s;
 }
 
+// Savegames are written to disk by a worker thread. The game state is
+// serialized into savebuffer on the game thread as before, copied and handed
+// over; the worker optionally compresses it, writes a temporary file and
+// renames it over the old savegame.
+
+static boolean savegame_compression;
+
+// A compressed savegame keeps the description, version and snapshot
+// uncompressed, so that the menu can still read them.
+static const byte savegame_zmagic[4] = {0, 'W', 'Z', 1};
+#define SAVEGAME_ZHEADER (sizeof(savegame_zmagic) + 8)
+
+typedef struct
+{
+  char *name;
+  byte *data;
+  size_t length;
+  boolean compress;
+  boolean success;
+  int error;
+} savejob_t;
+
+static savejob_t savejob;
+static SDL_Thread *savethread;
+static SDL_AtomicInt savedone;
+
+static void WriteLE32(byte *p, uint32_t value)
+{
+  p[0] = value & 0xff;
+  p[1] = (value >> 8) & 0xff;
+  p[2] = (value >> 16) & 0xff;
+  p[3] = (value >> 24) & 0xff;
+}
+
+static uint32_t ReadLE32(const byte *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static byte *CompressSaveGame(const byte *data, size_t length, size_t *outlength)
+{
+  const size_t header = SAVESTRINGSIZE + VERSIONSIZE;
+  const size_t snapshot = MN_SnapshotDataSize();
+
+  if (length < header + snapshot)
+    return NULL;
+
+  const size_t bodylength = length - header - snapshot;
+  mz_ulong zlength = mz_compressBound(bodylength);
+  byte *out = malloc(header + SAVEGAME_ZHEADER + zlength + snapshot);
+  byte *p = out;
+
+  memcpy(p, data, header);
+  p += header;
+  memcpy(p, savegame_zmagic, sizeof(savegame_zmagic));
+  p += sizeof(savegame_zmagic);
+
+  if (mz_compress2(p + 8, &zlength, data + header, bodylength,
+                   MZ_BEST_SPEED) != MZ_OK)
+  {
+    free(out);
+    return NULL;
+  }
+
+  WriteLE32(p, bodylength);
+  WriteLE32(p + 4, zlength);
+  p += 8 + zlength;
+
+  memcpy(p, data + header + bodylength, snapshot);
+  p += snapshot;
+
+  *outlength = p - out;
+  return out;
+}
+
+// Replace a compressed savegame in savebuffer by its uncompressed contents.
+
+static void UncompressSaveGame(void)
+{
+  const size_t header = SAVESTRINGSIZE + VERSIONSIZE;
+  const size_t snapshot = MN_SnapshotDataSize();
+
+  if (savegamesize < header + SAVEGAME_ZHEADER + snapshot
+      || memcmp(savebuffer + header, savegame_zmagic, sizeof(savegame_zmagic)))
+  {
+    return;
+  }
+
+  const byte *p = savebuffer + header + sizeof(savegame_zmagic);
+  mz_ulong bodylength = ReadLE32(p);
+  const mz_ulong zlength = ReadLE32(p + 4);
+  p += 8;
+
+  if (header + SAVEGAME_ZHEADER + zlength + snapshot != savegamesize)
+    I_Error("Savegame %s is corrupt", savename);
+
+  const size_t length = header + bodylength + snapshot;
+  byte *buffer = Z_Malloc(length, PU_STATIC, 0);
+
+  memcpy(buffer, savebuffer, header);
+
+  if (mz_uncompress(buffer + header, &bodylength, p, zlength) != MZ_OK
+      || header + bodylength + snapshot != length)
+  {
+    I_Error("Savegame %s is corrupt", savename);
+  }
+
+  memcpy(buffer + header + bodylength, p + zlength, snapshot);
+
+  Z_Free(savebuffer);
+  savebuffer = buffer;
+  savegamesize = length;
+}
+
+static int SaveGameThread(void *data)
+{
+  savejob_t *job = data;
+  const byte *out = job->data;
+  size_t length = job->length;
+  byte *compressed = NULL;
+
+  if (job->compress)
+  {
+    compressed = CompressSaveGame(job->data, job->length, &length);
+    if (compressed)
+      out = compressed;
+    else
+      length = job->length;
+  }
+
+  char *tmpname = M_StringJoin(job->name, ".tmp");
+
+  errno = 0;
+  job->success = M_WriteFile(tmpname, (void *)out, length);
+
+  // rename() replaces the old savegame atomically, except on Windows
+  if (job->success && M_rename(tmpname, job->name))
+  {
+    M_remove(job->name);
+    if (M_rename(tmpname, job->name))
+    {
+      job->success = false;
+      M_remove(tmpname);
+    }
+  }
+
+  job->error = errno;
+
+  free(tmpname);
+  free(compressed);
+
+  SDL_SetAtomicInt(&savedone, 1);
+  return 0;
+}
+
+static void WaitSaveGame(void)
+{
+  if (savethread)
+  {
+    SDL_WaitThread(savethread, NULL);
+    savethread = NULL;
+  }
+}
+
+// Wait for a pending savegame to be written and report the result.
+
+static void FinishSaveGame(void)
+{
+  if (!savejob.name)
+    return;
+
+  WaitSaveGame();
+
+  if (!savejob.success)
+  {
+    displaymsg("%s", savejob.error ? strerror(savejob.error)
+                                   : "Could not save game: Error unknown");
+  }
+  else
+  {
+    displaymsg("%s", s_GGSAVED); // Ty 03/27/98 - externalized
+  }
+
+  free(savejob.name);
+  free(savejob.data);
+  memset(&savejob, 0, sizeof(savejob));
+}
+
+static void CheckSaveGame(void)
+{
+  if (savejob.name && SDL_GetAtomicInt(&savedone))
+    FinishSaveGame();
+}
+
+static void QueueSaveGame(const char *name, const byte *data, size_t length)
+{
+  static boolean atexit_registered;
+
+  FinishSaveGame();
+
+  if (!atexit_registered)
+  {
+    I_AtExit(WaitSaveGame, true);
+    atexit_registered = true;
+  }
+
+  savejob.name = M_StringDuplicate(name);
+  savejob.data = malloc(length);
+  memcpy(savejob.data, data, length);
+  savejob.length = length;
+  savejob.compress = savegame_compression;
+
+  SDL_SetAtomicInt(&savedone, 0);
+  savethread = SDL_CreateThread(SaveGameThread, "SaveGame", &savejob);
+
+  if (!savethread)
+  {
+    I_Printf(VB_WARNING, "QueueSaveGame: %s", SDL_GetError());
+    SaveGameThread(&savejob);
+    FinishSaveGame();
+  }
+}
+
 static void DoSaveGame(char *name)
 {
   S_MarkSounds();
@@ -2554,15 +2797,7 @@ static void DoSaveGame(char *name)
 
   M_MakeDirectory(basesavegame);
 
-  if (!M_WriteFile(name, savebuffer, length))
-  {
-      displaymsg("%s", errno ? strerror(errno)
-                             : "Could not save game: Error unknown");
-  }
-  else
-  {
-      displaymsg("%s", s_GGSAVED); // Ty 03/27/98 - externalized
-  }
+  QueueSaveGame(name, savebuffer, length);
 
   Z_Free(savebuffer);  // killough
   savebuffer = save_p = NULL;
@@ -2626,7 +2861,11 @@ static boolean DoLoadGame(boolean do_load_autosave)
 
   gameaction = ga_nothing;
 
+  // the savegame may still be being written
+  FinishSaveGame();
+
   savegamesize = M_ReadFile(savename, &savebuffer);
+  UncompressSaveGame();
 
   save_p = savebuffer + SAVESTRINGSIZE;
 
@@ -2929,10 +3168,57 @@ void G_CleanScreenshot(void)
 // Make ticcmd_ts for the players.
 //
 
+// Report the progress of a timed demo running without display.
+
+#define HEADLESS_REPORT_INTERVAL 5000 // [ms]
+
+static void G_HeadlessProgress(void)
+{
+  static int lasttime, lasttic;
+
+  if (!timingdemo || !demoplayback)
+    return;
+
+  const int time = I_GetTimeMS();
+
+  if (!lasttime)
+  {
+    lasttime = time;
+    lasttic = gametic;
+    return;
+  }
+
+  if (time - lasttime < HEADLESS_REPORT_INTERVAL)
+    return;
+
+  I_Printf(VB_INFO, "Demo playback: %d/%d tics, %d gametics per second",
+           playback_tic, playback_totaltics,
+           (gametic - lasttic) * 1000 / (time - lasttime));
+
+  lasttime = time;
+  lasttic = gametic;
+}
+
+// Status bar, HUD and automap do not affect the game state.
+
+static void G_DisplayTicker(void)
+{
+  if (headless)
+  {
+    G_HeadlessProgress();
+    return;
+  }
+
+  ST_Ticker();
+  AM_Ticker();
+}
+
 void G_Ticker(void)
 {
   int i;
 
+  CheckSaveGame();
+
   // do player reborns if needed
   P_MapStart();
   for (i=0 ; i<MAXPLAYERS ; i++)
@@ -3017,7 +3303,10 @@ void G_Ticker(void)
   else
     {
       if (!timingdemo && gamestate == GS_LEVEL && gameaction == ga_nothing)
+      {
         G_SaveAutoKeyframe();
+        G_SaveDemoKeyframe();
+      }
       
       // get commands, check consistancy, and build new consistancy check
       int buf = (gametic/ticdup)%BACKUPTICS;
@@ -3077,8 +3366,11 @@ void G_Ticker(void)
 
       if (demoplayback)
         ++playback_tic;
+      else if (demorecording && !(gametic % TICRATE))
+        G_StreamDemo();
 
-      HU_UpdateCommandHistory(&players[displayplayer].cmd);
+      if (!headless)
+        HU_UpdateCommandHistory(&players[displayplayer].cmd);
 
       // check for special buttons
       for (i=0; i<MAXPLAYERS; i++)
@@ -3129,7 +3421,7 @@ void G_Ticker(void)
   // killough 9/29/98: split up switch statement
   // into pauseable and unpauseable parts.
 
-  gamestate == GS_LEVEL ? P_Ticker(), ST_Ticker(), AM_Ticker() :
+  gamestate == GS_LEVEL ? P_Ticker(), G_DisplayTicker() :
     paused & 2 ? (void) 0 :
       gamestate == GS_INTERMISSION ? WI_Ticker() :
 	gamestate == GS_FINALE ? F_Ticker() :
@@ -4774,6 +5066,8 @@ boolean G_CheckDemoStatus(void)
       int endtime = I_GetTime_RealTime();
       // killough -- added fps information and made it work for longer demos:
       unsigned realtics = endtime-starttime;
+      I_Printf(VB_INFO, "Rendered %d frames, %d zone allocations in %d frames",
+               rendered_frames, rendered_allocs, rendered_alloc_frames);
       I_Success("Timed %u gametics in %u realtics = %-.1f frames per second",
                (unsigned) gametic,realtics,
                (unsigned) gametic * (double) TICRATE / realtics);
@@ -4826,14 +5120,21 @@ boolean G_CheckDemoStatus(void)
       if (!demo_p)
         return false;
 
+      demo_streampos = MIN(demo_streampos, (size_t)(demo_p - demobuffer));
+
       *demo_p++ = DEMOMARKER;
 
       G_AddDemoFooter();
 
-      if (!M_WriteFile(demoname, demobuffer, demo_p - demobuffer))
+      // write the whole demo if streaming failed or never started
+      if (!G_CloseDemoStream(demobuffer + demo_streampos, demo_streampos,
+                             demo_p - demobuffer - demo_streampos)
+          && !M_WriteFile(demoname, demobuffer, demo_p - demobuffer))
 	I_Error("Error recording demo %s: %s", demoname,  // killough 11/98
 		errno ? strerror(errno) : "(Unknown Error)");
 
+      demo_streampos = 0;
+
       Z_Free(demobuffer);
       demobuffer = NULL;  // killough
       I_Printf(VB_ALWAYS, "Demo %s recorded", demoname);
@@ -4905,6 +5206,7 @@ void G_BindGameVariables(void)
     "Use-button action upon death (0 = Default; 1 = Last Save; 2 = Nothing)");
   BIND_BOOL_GENERAL(autosave, true,
     "Auto save at the beginning of a map, after completing the previous one");
+  BIND_BOOL(savegame_compression, false, "Compress savegames");
 }
 
 void G_BindEnemVariables(void)
@@ -34,6 +34,15 @@ struct event_s;
 
 #define MBF21_GAME_OPTION_SIZE (21 + MBF21_COMP_TOTAL)
 
+// killough 2/28/98: A ridiculously large number
+// of players, the most you'll ever need in a demo
+// or savegame. This is used to prevent problems, in
+// case more players in a game are supported later.
+
+#define MIN_MAXPLAYERS 32
+
+#define DEMOMARKER    0x80
+
 void G_UpdateLocalViewFunction(void);
 void G_PrepMouseTiccmd(void);
 void G_PrepGamepadTiccmd(void);
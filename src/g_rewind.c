@@ -13,10 +13,15 @@
 
 #include "p_keyframe.h"
 
+#include "d_event.h"
+#include "doomstat.h"
 #include "doomtype.h"
 #include "g_game.h"
 #include "i_timer.h"
+#include "m_array.h"
 #include "m_config.h"
+#include "s_sound.h"
+#include "st_widgets.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -176,6 +181,7 @@ void G_LoadAutoKeyframe(void)
         }
 
         P_LoadKeyframe(keyframe);
+        S_ClearVirtualVoices();
         displaymsg("Restored key frame");
 
         if (tic == 0) // don't delete first keyframe
@@ -192,11 +198,173 @@ void G_LoadAutoKeyframe(void)
     }
 }
 
+// Demo playback keeps an index of key frames of the current level, so that
+// seeking costs at most one interval of simulation. When the index is full,
+// every other key frame is dropped and the interval is doubled.
+
+#define MAX_DEMO_KEYFRAMES 128
+
+static int demo_keyframe_interval;
+
+typedef struct
+{
+    int tic;
+    keyframe_t *keyframe;
+} demokeyframe_t;
+
+static demokeyframe_t *demo_keyframes; // sorted by tic
+static int demo_interval_tics;
+static int demo_levelstart_tic;
+
+static void FreeDemoKeyframes(void)
+{
+    demokeyframe_t *elem;
+    array_foreach(elem, demo_keyframes)
+    {
+        P_FreeKeyframe(elem->keyframe);
+    }
+    array_free(demo_keyframes);
+}
+
+// Index of the first key frame with a tic greater than the given one.
+static int UpperBound(int tic)
+{
+    int lo = 0, hi = array_size(demo_keyframes);
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (demo_keyframes[mid].tic <= tic)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static void ThinDemoKeyframes(void)
+{
+    demo_interval_tics *= 2;
+
+    int count = 0;
+    for (int i = 0; i < array_size(demo_keyframes); ++i)
+    {
+        demokeyframe_t elem = demo_keyframes[i];
+        if ((elem.tic - demo_levelstart_tic) % demo_interval_tics)
+        {
+            P_FreeKeyframe(elem.keyframe);
+        }
+        else
+        {
+            demo_keyframes[count++] = elem;
+        }
+    }
+    array_ptr(demo_keyframes)->size = count;
+}
+
+void G_SaveDemoKeyframe(void)
+{
+    if (!demoplayback || timingdemo || !demo_keyframe_interval)
+    {
+        return;
+    }
+
+    if (!demo_interval_tics)
+    {
+        demo_interval_tics = demo_keyframe_interval * TICRATE;
+        demo_levelstart_tic = playback_tic;
+    }
+
+    if ((playback_tic - demo_levelstart_tic) % demo_interval_tics)
+    {
+        return;
+    }
+
+    int pos = UpperBound(playback_tic);
+
+    // already indexed, e.g. after seeking backwards
+    if (pos > 0 && demo_keyframes[pos - 1].tic == playback_tic)
+    {
+        return;
+    }
+
+    demokeyframe_t elem = {playback_tic, P_SaveKeyframe(playback_tic)};
+    array_push(demo_keyframes, elem);
+    memmove(&demo_keyframes[pos + 1], &demo_keyframes[pos],
+            (array_size(demo_keyframes) - 1 - pos) * sizeof(elem));
+    demo_keyframes[pos] = elem;
+
+    if (array_size(demo_keyframes) > MAX_DEMO_KEYFRAMES)
+    {
+        ThinDemoKeyframes();
+    }
+}
+
+void G_DemoSeek(int tic)
+{
+    if (!demoplayback || PLAYBACK_SKIP || !playback_totaltics)
+    {
+        return;
+    }
+
+    tic = CLAMP(tic, 1, playback_totaltics - 1);
+
+    // the rewind key frames are not valid after seeking
+    FreeKeyframeQueue();
+    current_tic = 0;
+
+    int pos = UpperBound(tic);
+
+    if (pos > 0)
+    {
+        const demokeyframe_t *elem = &demo_keyframes[pos - 1];
+
+        // skip the key frame if it is between us and the target
+        if (tic < playback_tic || elem->tic > playback_tic)
+        {
+            P_LoadKeyframe(elem->keyframe);
+            S_ClearVirtualVoices();
+        }
+    }
+    else if (tic < playback_tic)
+    {
+        // the target is before the current level, start over
+        playback_tic = 0;
+        gameaction = ga_playdemo;
+    }
+
+    if (tic > playback_tic)
+    {
+        playback_skiptics = tic;
+        G_EnableWarp(true);
+    }
+
+    displaymsg("Demo: %d:%02d", tic / TICRATE / 60, tic / TICRATE % 60);
+}
+
+int G_NumDemoKeyframes(void)
+{
+    return array_size(demo_keyframes);
+}
+
+int G_DemoKeyframeTic(int index)
+{
+    return demo_keyframes[index].tic;
+}
+
 void G_ResetRewind(void)
 {
     FreeKeyframeQueue();
     current_tic = 0;
     disable_rewind = false;
+
+    FreeDemoKeyframes();
+    demo_interval_tics = 0;
 }
 
 void G_BindRewindVariables(void)
@@ -209,4 +377,6 @@ void G_BindRewindVariables(void)
         "Time to store a key frame, in milliseconds; if exceeded, storing "
         "will stop (0 = No limit)");
     BIND_BOOL(rewind_auto, true, "Enable storing rewind key frames");
+    BIND_NUM(demo_keyframe_interval, 10, 0, 600,
+        "Demo seek key frame interval in seconds (0 = Off)");
 }
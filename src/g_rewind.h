@@ -18,6 +18,11 @@ void G_SaveAutoKeyframe(void);
 void G_LoadAutoKeyframe(void);
 void G_ResetRewind(void);
 
+void G_SaveDemoKeyframe(void);
+void G_DemoSeek(int tic);
+int G_NumDemoKeyframes(void);
+int G_DemoKeyframeTic(int index);
+
 void G_BindRewindVariables(void);
 
 #endif
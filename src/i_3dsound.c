@@ -347,6 +347,7 @@ const sound_module_t sound_3d_module =
     I_3D_ReinitSound,
     I_OAL_AllowReinitSound,
     I_OAL_CacheSound,
+    I_OAL_CacheSounds,
     I_3D_AdjustSoundParams,
     I_3D_UpdateSoundParams,
     I_3D_UpdateListenerParams,
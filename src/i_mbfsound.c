@@ -182,6 +182,7 @@ const sound_module_t sound_mbf_module =
     I_MBF_ReinitSound,
     I_OAL_AllowReinitSound,
     I_OAL_CacheSound,
+    I_OAL_CacheSounds,
     I_MBF_AdjustSoundParams,
     I_MBF_UpdateSoundParams,
     NULL,
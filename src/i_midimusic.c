@@ -35,6 +35,7 @@
 
 static SDL_Thread *player_thread_handle;
 static SDL_Mutex *music_lock;
+static SDL_Condition *music_cond; // wakes up the player thread
 static SDL_AtomicInt player_thread_running;
 
 static boolean music_initialized;
@@ -138,6 +139,14 @@ typedef struct
     unsigned int elapsed_time;
     unsigned int saved_elapsed_time;
     unsigned int num_tracks;
+
+    // Merged events of all tracks, NULL if the song has track loops and is
+    // played with one iterator per track.
+    const midi_stream_event_t *stream;
+    unsigned int num_stream_events;
+    unsigned int stream_pos;
+    unsigned int saved_stream_pos;
+
     boolean looping;
     boolean ff_loop;
     boolean ff_restart;
@@ -601,21 +610,30 @@ static void SendSysExMsg(const midi_event_t *event)
     }
 }
 
-// Sets a Final Fantasy or RPG Maker loop point.
+// Sets a Final Fantasy, RPG Maker or EMIDI global loop point.
 
 static void SetLoopPoint(void)
 {
     unsigned int i;
 
-    for (i = 0; i < song.num_tracks; ++i)
+    if (song.stream)
     {
-        MIDI_SetLoopPoint(song.tracks[i].iter);
-        song.tracks[i].saved_end_of_track = song.tracks[i].end_of_track;
-        song.tracks[i].saved_elapsed_time = song.tracks[i].elapsed_time;
+        song.saved_stream_pos = song.stream_pos;
+    }
+    else
+    {
+        for (i = 0; i < song.num_tracks; ++i)
+        {
+            MIDI_SetLoopPoint(song.tracks[i].iter);
+            song.tracks[i].saved_end_of_track = song.tracks[i].end_of_track;
+            song.tracks[i].saved_elapsed_time = song.tracks[i].elapsed_time;
+        }
     }
     song.saved_elapsed_time = song.elapsed_time;
 }
 
+static void RestartLoop(void);
+
 // Checks if the MIDI meta message contains a Final Fantasy loop marker.
 
 static void CheckFFLoop(const midi_event_t *event)
@@ -693,19 +711,22 @@ static void SendEMIDI(const midi_event_t *event, midi_track_t *track)
             for (i = 0; i < song.num_tracks; ++i)
             {
                 song.tracks[i].emidi_loop_count = count;
-                MIDI_SetLoopPoint(song.tracks[i].iter);
-                song.tracks[i].saved_end_of_track = song.tracks[i].end_of_track;
-                song.tracks[i].saved_elapsed_time = song.tracks[i].elapsed_time;
             }
-            song.saved_elapsed_time = song.elapsed_time;
+            SetLoopPoint();
             break;
 
         case EMIDI_CONTROLLER_GLOBAL_LOOP_END:
             if (event->data.channel.param2 == EMIDI_LOOP_FLAG)
             {
+                // Without track loops all the counters are the same.
+                if (song.stream && track->emidi_loop_count != 0)
+                {
+                    RestartLoop();
+                }
+
                 for (i = 0; i < song.num_tracks; ++i)
                 {
-                    if (song.tracks[i].emidi_loop_count != 0)
+                    if (!song.stream && song.tracks[i].emidi_loop_count != 0)
                     {
                         MIDI_RestartAtLoopPoint(song.tracks[i].iter);
                         song.tracks[i].end_of_track = song.tracks[i].saved_end_of_track;
@@ -1035,11 +1056,18 @@ static void RestartLoop(void)
 {
     unsigned int i;
 
-    for (i = 0; i < song.num_tracks; ++i)
+    if (song.stream)
     {
-        MIDI_RestartAtLoopPoint(song.tracks[i].iter);
-        song.tracks[i].end_of_track = song.tracks[i].saved_end_of_track;
-        song.tracks[i].elapsed_time = song.tracks[i].saved_elapsed_time;
+        song.stream_pos = song.saved_stream_pos;
+    }
+    else
+    {
+        for (i = 0; i < song.num_tracks; ++i)
+        {
+            MIDI_RestartAtLoopPoint(song.tracks[i].iter);
+            song.tracks[i].end_of_track = song.tracks[i].saved_end_of_track;
+            song.tracks[i].elapsed_time = song.tracks[i].saved_elapsed_time;
+        }
     }
     song.elapsed_time = song.saved_elapsed_time;
     RestartTimer(TicksToUS(song.elapsed_time));
@@ -1089,10 +1117,67 @@ static void RestartTracks(void)
         song.tracks[i].end_of_track = false;
         song.tracks[i].emidi_loop_count = 0;
     }
+    song.stream_pos = 0;
     song.elapsed_time = 0;
     RestartTimer(0);
 }
 
+// No more events. Restart or stop song.
+
+static midi_state_t EndOfSong(void)
+{
+    if (song.elapsed_time)
+    {
+        if (song.ff_restart || song.rpg_loop)
+        {
+            song.ff_restart = false;
+            RestartLoop();
+            return STATE_PLAYING;
+        }
+        else if (song.looping)
+        {
+            ResetControllersVolume();
+            RestartTracks();
+            return STATE_PLAYING;
+        }
+    }
+    return STATE_STOPPED;
+}
+
+// Same as NextEvent, for songs played from the merged event stream.
+
+static midi_state_t NextStreamEvent(midi_position_t *position)
+{
+    if (song.stream_pos == song.num_stream_events)
+    {
+        return EndOfSong();
+    }
+
+    const midi_stream_event_t *next = &song.stream[song.stream_pos++];
+    midi_track_t *track = &song.tracks[next->track];
+    const unsigned int delta_time = next->time - song.elapsed_time;
+
+    song.elapsed_time = next->time;
+
+    // Restart FF loop after sending all events that share same ticks_per_beat.
+    if (song.ff_restart && next->next_delta > 0)
+    {
+        song.ff_restart = false;
+        RestartLoop();
+        return STATE_PLAYING;
+    }
+
+    if (!delta_time)
+    {
+        ProcessEvent(next->event, track);
+        return STATE_PLAYING;
+    }
+
+    position->track = track;
+    position->event = next->event;
+    return STATE_WAITING;
+}
+
 // Get the next event from the MIDI file, process it or return if the delta
 // time is > 0.
 
@@ -1103,6 +1188,11 @@ static midi_state_t NextEvent(midi_position_t *position)
     unsigned int min_time = UINT_MAX;
     unsigned int delta_time;
 
+    if (song.stream)
+    {
+        return NextStreamEvent(position);
+    }
+
     // Find next event across all tracks.
     for (int i = 0; i < song.num_tracks; ++i)
     {
@@ -1118,25 +1208,9 @@ static midi_state_t NextEvent(midi_position_t *position)
         }
     }
 
-    // No more events. Restart or stop song.
     if (track == NULL)
     {
-        if (song.elapsed_time)
-        {
-            if (song.ff_restart || song.rpg_loop)
-            {
-                song.ff_restart = false;
-                RestartLoop();
-                return STATE_PLAYING;
-            }
-            else if (song.looping)
-            {
-                ResetControllersVolume();
-                RestartTracks();
-                return STATE_PLAYING;
-            }
-        }
-        return STATE_STOPPED;
+        return EndOfSong();
     }
 
     track->elapsed_time = min_time;
@@ -1288,6 +1362,13 @@ static boolean RegisterSong(void)
 
     song.rpg_loop = MIDI_RPGLoop(song.file);
 
+    if (!MIDI_HasTrackLoops(song.file))
+    {
+        song.stream = MIDI_GetEventStream(song.file, &song.num_stream_events);
+        song.stream_pos = 0;
+        song.saved_stream_pos = 0;
+    }
+
     if (!song.rpg_loop)
     {
         InitEMIDI();
@@ -1344,6 +1425,14 @@ static int PlayerThread(void *unused)
                 {
                     int64_t remaining_time =
                         TicksToUS(song.elapsed_time) - CurrentTime();
+                    if (remaining_time > 2000)
+                    {
+                        // Sleep until shortly before the next event, unless
+                        // woken up to pause or stop.
+                        SDL_WaitConditionTimeout(music_cond, music_lock,
+                                                 (remaining_time - 1000) / 1000);
+                        break;
+                    }
                     if (remaining_time > 1000)
                     {
                         sleep = true;
@@ -1356,7 +1445,10 @@ static int PlayerThread(void *unused)
 
             case STATE_STOPPED:
             case STATE_PAUSED:
-                sleep = true;
+                if (SDL_GetAtomicInt(&player_thread_running))
+                {
+                    SDL_WaitCondition(music_cond, music_lock);
+                }
                 break;
         }
 
@@ -1461,8 +1553,12 @@ static void I_MID_StopSong(void *handle)
         return;
     }
 
+    SDL_LockMutex(music_lock);
     SDL_SetAtomicInt(&player_thread_running, 0);
+    SDL_SignalCondition(music_cond);
+    SDL_UnlockMutex(music_lock);
     SDL_WaitThread(player_thread_handle, NULL);
+    SDL_DestroyCondition(music_cond);
     SDL_DestroyMutex(music_lock);
 
     // Send notes/sound off to prevent hanging notes.
@@ -1480,6 +1576,7 @@ static void I_MID_PlaySong(void *handle, boolean looping)
     song.looping = looping;
     midi_state = STATE_STARTUP;
     music_lock = SDL_CreateMutex();
+    music_cond = SDL_CreateCondition();
     player_thread_handle = SDL_CreateThread(PlayerThread, NULL, NULL);
 }
 
@@ -1493,6 +1590,7 @@ static void I_MID_PauseSong(void *handle)
     SDL_LockMutex(music_lock);
     old_state = midi_state;
     midi_state = STATE_PAUSING;
+    SDL_SignalCondition(music_cond);
     SDL_UnlockMutex(music_lock);
 }
 
@@ -1508,6 +1606,7 @@ static void I_MID_ResumeSong(void *handle)
     {
         RestartTimer(0);
         midi_state = old_state;
+        SDL_SignalCondition(music_cond);
     }
     SDL_UnlockMutex(music_lock);
 }
@@ -1572,6 +1671,8 @@ static void I_MID_UnRegisterSong(void *handle)
     song.ff_loop = false;
     song.ff_restart = false;
     song.rpg_loop = false;
+    song.stream = NULL;
+    song.num_stream_events = 0;
 }
 
 static void I_MID_ShutdownMusic(void)
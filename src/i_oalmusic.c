@@ -91,6 +91,15 @@ static stream_player_t player;
 static SDL_Thread *player_thread_handle;
 static SDL_AtomicInt player_thread_running;
 
+// The player thread sleeps until the oldest buffer is played out, or until it
+// is woken up to pause, resume or stop.
+static SDL_Mutex *player_mutex;
+static SDL_Condition *player_cond;
+static boolean player_paused;
+
+// Number of times the source ran out of queued buffers.
+static SDL_AtomicInt player_underruns;
+
 static boolean music_initialized;
 
 static ebur128_state *ebur_state;
@@ -278,6 +287,11 @@ static boolean UpdatePlayer(void)
             return false;
         }
 
+        if (state == AL_STOPPED)
+        {
+            SDL_AddAtomicInt(&player_underruns, 1);
+        }
+
         alSourcePlay(player.source);
         if (alGetError() != AL_NO_ERROR)
         {
@@ -289,6 +303,21 @@ static boolean UpdatePlayer(void)
     return true;
 }
 
+// Time until the buffer being played is processed, in milliseconds.
+
+static Sint32 NextBufferTime(void)
+{
+    ALint offset;
+
+    alGetSourcei(player.source, AL_SAMPLE_OFFSET, &offset);
+    if (alGetError() != AL_NO_ERROR || offset >= BUFFER_SAMPLES)
+    {
+        return 1;
+    }
+
+    return MAX(1, (BUFFER_SAMPLES - offset) * 1000 / player.freq);
+}
+
 static boolean StartPlayer(void)
 {
     int i;
@@ -347,9 +376,23 @@ static int PlayerThread(void *unused)
         if (!UpdatePlayer())
         {
             SDL_SetAtomicInt(&player_thread_running, 0);
+            break;
         }
 
-        SDL_Delay(1);
+        SDL_LockMutex(player_mutex);
+        if (SDL_GetAtomicInt(&player_thread_running))
+        {
+            if (player_paused)
+            {
+                SDL_WaitCondition(player_cond, player_mutex);
+            }
+            else
+            {
+                SDL_WaitConditionTimeout(player_cond, player_mutex,
+                                         NextBufferTime());
+            }
+        }
+        SDL_UnlockMutex(player_mutex);
     }
 
     return 0;
@@ -365,6 +408,12 @@ boolean I_OAL_InitStream(void)
     alGenBuffers(NUM_BUFFERS, player.buffers);
     alGenSources(1, &player.source);
 
+    if (!player_mutex)
+    {
+        player_mutex = SDL_CreateMutex();
+        player_cond = SDL_CreateCondition();
+    }
+
     alSourcef(player.source, AL_MAX_GAIN, 10.0f);
 
     // Set parameters so mono sources play out the front-center speaker and
@@ -479,6 +528,10 @@ static void I_OAL_PauseSong(void *handle)
     }
 
     alSourcePause(player.source);
+
+    SDL_LockMutex(player_mutex);
+    player_paused = true;
+    SDL_UnlockMutex(player_mutex);
 }
 
 static void I_OAL_ResumeSong(void *handle)
@@ -489,6 +542,11 @@ static void I_OAL_ResumeSong(void *handle)
     }
 
     alSourcePlay(player.source);
+
+    SDL_LockMutex(player_mutex);
+    player_paused = false;
+    SDL_SignalCondition(player_cond);
+    SDL_UnlockMutex(player_mutex);
 }
 
 static void I_OAL_PlaySong(void *handle, boolean looping)
@@ -507,6 +565,9 @@ static void I_OAL_PlaySong(void *handle, boolean looping)
         return;
     }
 
+    player_paused = false;
+    SDL_SetAtomicInt(&player_underruns, 0);
+
     SDL_SetAtomicInt(&player_thread_running, 1);
     player_thread_handle = SDL_CreateThread(PlayerThread, NULL, NULL);
 }
@@ -520,9 +581,18 @@ static void I_OAL_StopSong(void *handle)
 
     alSourceStop(player.source);
 
+    SDL_LockMutex(player_mutex);
     SDL_SetAtomicInt(&player_thread_running, 0);
+    SDL_SignalCondition(player_cond);
+    SDL_UnlockMutex(player_mutex);
     SDL_WaitThread(player_thread_handle, NULL);
 
+    const int underruns = SDL_GetAtomicInt(&player_underruns);
+    if (underruns)
+    {
+        I_Printf(VB_DEBUG, "I_OAL_StopSong: %d buffer underruns.", underruns);
+    }
+
     if (alGetError() != AL_NO_ERROR)
     {
         I_Printf(VB_ERROR, "I_OAL_StopSong: Error stopping playback.");
@@ -21,6 +21,7 @@
 #include "alext.h"
 #include "efx.h"
 
+#include <SDL3/SDL.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,6 +64,202 @@ oal_system_t *oal;
 static LPALDEFERUPDATESSOFT alDeferUpdatesSOFT;
 static LPALPROCESSUPDATESSOFT alProcessUpdatesSOFT;
 
+// Source and listener parameters are collected here and only the ones that
+// differ from what OpenAL already has are sent, all at once when updates are
+// processed, or for a single source right before it starts playing.
+
+typedef enum
+{
+    SRC_GAIN,
+    SRC_PITCH,
+    SRC_ROLLOFF_FACTOR,
+    SRC_REFERENCE_DISTANCE,
+    SRC_MAX_DISTANCE,
+    SRC_SOURCE_RADIUS,
+    SRC_AIR_ABSORPTION_FACTOR,
+    SRC_SOURCE_RELATIVE, // integer parameters from here on
+    SRC_LOOPING,
+    NUM_SRC_SCALARS
+} src_scalar_t;
+
+typedef enum
+{
+    SRC_POSITION,
+    SRC_VELOCITY,
+    NUM_SRC_VECTORS
+} src_vector_t;
+
+static const ALenum src_scalar_params[NUM_SRC_SCALARS] = {
+    AL_GAIN, AL_PITCH, AL_ROLLOFF_FACTOR, AL_REFERENCE_DISTANCE,
+    AL_MAX_DISTANCE, AL_SOURCE_RADIUS, AL_AIR_ABSORPTION_FACTOR,
+    AL_SOURCE_RELATIVE, AL_LOOPING
+};
+
+static const ALenum src_vector_params[NUM_SRC_VECTORS] = {
+    AL_POSITION, AL_VELOCITY
+};
+
+#define SCALAR_BIT(p) (1u << (p))
+#define VECTOR_BIT(p) (1u << (NUM_SRC_SCALARS + (p)))
+
+static struct
+{
+    ALfloat scalar[NUM_SRC_SCALARS][MAX_CHANNELS];
+    ALfloat sent_scalar[NUM_SRC_SCALARS][MAX_CHANNELS];
+    ALfloat vector[NUM_SRC_VECTORS][MAX_CHANNELS][3];
+    ALfloat sent_vector[NUM_SRC_VECTORS][MAX_CHANNELS][3];
+    unsigned int dirty[MAX_CHANNELS];
+    unsigned int sent[MAX_CHANNELS]; // values known to OpenAL
+
+    ALfloat listener[3][6];      // position, velocity, orientation
+    ALfloat sent_listener[3][6];
+    unsigned int listener_dirty;
+    unsigned int listener_sent;
+
+    // Statistics, printed every BATCH_STATS_INTERVAL updates.
+    int requests;
+    int calls;
+    int updates;
+} batch;
+
+#define BATCH_STATS_INTERVAL 1000
+
+static void SetScalar(int channel, src_scalar_t p, ALfloat value)
+{
+    const unsigned int bit = SCALAR_BIT(p);
+
+    batch.scalar[p][channel] = value;
+    batch.requests++;
+
+    if ((batch.sent[channel] & bit) && batch.sent_scalar[p][channel] == value)
+    {
+        batch.dirty[channel] &= ~bit;
+    }
+    else
+    {
+        batch.dirty[channel] |= bit;
+    }
+}
+
+static void SetVector(int channel, src_vector_t p, ALfloat x, ALfloat y,
+                      ALfloat z)
+{
+    const unsigned int bit = VECTOR_BIT(p);
+    ALfloat *v = batch.vector[p][channel];
+    const ALfloat *sent = batch.sent_vector[p][channel];
+
+    v[0] = x;
+    v[1] = y;
+    v[2] = z;
+    batch.requests++;
+
+    if ((batch.sent[channel] & bit) && !memcmp(v, sent, 3 * sizeof(*v)))
+    {
+        batch.dirty[channel] &= ~bit;
+    }
+    else
+    {
+        batch.dirty[channel] |= bit;
+    }
+}
+
+static void CommitSource(int channel)
+{
+    const ALuint source = oal->sources[channel];
+    unsigned int dirty = batch.dirty[channel];
+
+    for (int p = 0; dirty && p < NUM_SRC_SCALARS; p++)
+    {
+        if (!(dirty & SCALAR_BIT(p)))
+        {
+            continue;
+        }
+
+        const ALfloat value = batch.scalar[p][channel];
+
+        if (p >= SRC_SOURCE_RELATIVE)
+        {
+            alSourcei(source, src_scalar_params[p], (ALint)value);
+        }
+        else
+        {
+            alSourcef(source, src_scalar_params[p], value);
+        }
+
+        batch.sent_scalar[p][channel] = value;
+        dirty &= ~SCALAR_BIT(p);
+        batch.calls++;
+    }
+
+    for (int p = 0; dirty && p < NUM_SRC_VECTORS; p++)
+    {
+        if (!(dirty & VECTOR_BIT(p)))
+        {
+            continue;
+        }
+
+        alSourcefv(source, src_vector_params[p], batch.vector[p][channel]);
+        memcpy(batch.sent_vector[p][channel], batch.vector[p][channel],
+               sizeof(batch.sent_vector[p][channel]));
+        dirty &= ~VECTOR_BIT(p);
+        batch.calls++;
+    }
+
+    batch.sent[channel] |= batch.dirty[channel];
+    batch.dirty[channel] = 0;
+}
+
+static void CommitListener(void)
+{
+    static const ALenum params[] = {AL_POSITION, AL_VELOCITY, AL_ORIENTATION};
+
+    for (int i = 0; i < arrlen(params); i++)
+    {
+        if (batch.listener_dirty & (1u << i))
+        {
+            alListenerfv(params[i], batch.listener[i]);
+            memcpy(batch.sent_listener[i], batch.listener[i],
+                   sizeof(batch.sent_listener[i]));
+            batch.calls++;
+        }
+    }
+
+    batch.listener_sent |= batch.listener_dirty;
+    batch.listener_dirty = 0;
+}
+
+static void CommitUpdates(void)
+{
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        if (batch.dirty[i])
+        {
+            CommitSource(i);
+        }
+    }
+
+    CommitListener();
+
+    if (++batch.updates == BATCH_STATS_INTERVAL)
+    {
+        I_Printf(VB_DEBUG,
+                 "I_OAL_ProcessUpdates: %.1f AL calls per update "
+                 "(%.1f parameter changes requested)",
+                 (float)batch.calls / batch.updates,
+                 (float)batch.requests / batch.updates);
+        batch.requests = 0;
+        batch.calls = 0;
+        batch.updates = 0;
+    }
+}
+
+// Forget what OpenAL has, after the sources were reset behind our back.
+
+static void ResetBatch(void)
+{
+    memset(&batch, 0, sizeof(batch));
+}
+
 void I_OAL_DeferUpdates(void)
 {
     if (!oal)
@@ -80,6 +277,7 @@ void I_OAL_ProcessUpdates(void)
         return;
     }
 
+    CommitUpdates();
     alProcessUpdatesSOFT();
 }
 
@@ -240,20 +438,20 @@ void I_OAL_ResetSource2D(int channel)
 
     if (oal->EXT_EFX)
     {
-        alSourcef(oal->sources[channel], AL_AIR_ABSORPTION_FACTOR, 0.0f);
+        SetScalar(channel, SRC_AIR_ABSORPTION_FACTOR, 0.0f);
     }
 
     if (oal->EXT_SOURCE_RADIUS)
     {
-        alSourcef(oal->sources[channel], AL_SOURCE_RADIUS, 0.0f);
+        SetScalar(channel, SRC_SOURCE_RADIUS, 0.0f);
     }
 
-    alSource3f(oal->sources[channel], AL_POSITION, 0.0f, 0.0f, 0.0f);
-    alSource3f(oal->sources[channel], AL_VELOCITY, 0.0f, 0.0f, 0.0f);
-    alSourcef(oal->sources[channel], AL_ROLLOFF_FACTOR, 0.0f);
-    alSourcei(oal->sources[channel], AL_SOURCE_RELATIVE, AL_TRUE);
-    alSourcei(oal->sources[channel], AL_REFERENCE_DISTANCE, 0);
-    alSourcei(oal->sources[channel], AL_MAX_DISTANCE, 0);
+    SetVector(channel, SRC_POSITION, 0.0f, 0.0f, 0.0f);
+    SetVector(channel, SRC_VELOCITY, 0.0f, 0.0f, 0.0f);
+    SetScalar(channel, SRC_ROLLOFF_FACTOR, 0.0f);
+    SetScalar(channel, SRC_SOURCE_RELATIVE, AL_TRUE);
+    SetScalar(channel, SRC_REFERENCE_DISTANCE, 0.0f);
+    SetScalar(channel, SRC_MAX_DISTANCE, 0.0f);
 }
 
 void I_OAL_ResetSource3D(int channel, boolean point_source,
@@ -266,20 +464,19 @@ void I_OAL_ResetSource3D(int channel, boolean point_source,
 
     if (oal->EXT_EFX)
     {
-        alSourcef(oal->sources[channel], AL_AIR_ABSORPTION_FACTOR,
-                  oal->absorption);
+        SetScalar(channel, SRC_AIR_ABSORPTION_FACTOR, oal->absorption);
     }
 
     if (oal->EXT_SOURCE_RADIUS)
     {
-        alSourcef(oal->sources[channel], AL_SOURCE_RADIUS,
+        SetScalar(channel, SRC_SOURCE_RADIUS,
                   point_source ? 0.0f : OAL_SOURCE_RADIUS);
     }
 
-    alSourcef(oal->sources[channel], AL_ROLLOFF_FACTOR, OAL_ROLLOFF_FACTOR);
-    alSourcei(oal->sources[channel], AL_SOURCE_RELATIVE, AL_FALSE);
-    alSourcei(oal->sources[channel], AL_REFERENCE_DISTANCE, params->close_dist);
-    alSourcei(oal->sources[channel], AL_MAX_DISTANCE, params->clipping_dist);
+    SetScalar(channel, SRC_ROLLOFF_FACTOR, OAL_ROLLOFF_FACTOR);
+    SetScalar(channel, SRC_SOURCE_RELATIVE, AL_FALSE);
+    SetScalar(channel, SRC_REFERENCE_DISTANCE, params->close_dist);
+    SetScalar(channel, SRC_MAX_DISTANCE, params->clipping_dist);
 }
 
 void I_OAL_UpdateSourceParams(int channel, const ALfloat *position,
@@ -290,8 +487,8 @@ void I_OAL_UpdateSourceParams(int channel, const ALfloat *position,
         return;
     }
 
-    alSourcefv(oal->sources[channel], AL_POSITION, position);
-    alSourcefv(oal->sources[channel], AL_VELOCITY, velocity);
+    SetVector(channel, SRC_POSITION, position[0], position[1], position[2]);
+    SetVector(channel, SRC_VELOCITY, velocity[0], velocity[1], velocity[2]);
 }
 
 void I_OAL_UpdateListenerParams(const ALfloat *position,
@@ -303,9 +500,26 @@ void I_OAL_UpdateListenerParams(const ALfloat *position,
         return;
     }
 
-    alListenerfv(AL_POSITION, position);
-    alListenerfv(AL_VELOCITY, velocity);
-    alListenerfv(AL_ORIENTATION, orientation);
+    const ALfloat *values[] = {position, velocity, orientation};
+    const int sizes[] = {3, 3, 6};
+
+    for (int i = 0; i < arrlen(values); i++)
+    {
+        const size_t size = sizes[i] * sizeof(ALfloat);
+
+        memcpy(batch.listener[i], values[i], size);
+        batch.requests++;
+
+        if ((batch.listener_sent & (1u << i))
+            && !memcmp(batch.listener[i], batch.sent_listener[i], size))
+        {
+            batch.listener_dirty &= ~(1u << i);
+        }
+        else
+        {
+            batch.listener_dirty |= (1u << i);
+        }
+    }
 }
 
 const char **I_OAL_GetResamplerStrings(void)
@@ -360,6 +574,8 @@ static void ResetParams(void)
     const ALint default_orientation[] = {0, 0, -1, 0, 1, 0};
     int i;
 
+    ResetBatch();
+
     // Source parameters.
     for (i = 0; i < MAX_CHANNELS; i++)
     {
@@ -389,6 +605,11 @@ static void ResetParams(void)
     alSpeedOfSound(OAL_SPEED_OF_SOUND / OAL_METERS_PER_MAP_UNIT);
 
     UpdateUserSoundSettings();
+
+    for (i = 0; i < MAX_CHANNELS; i++)
+    {
+        CommitSource(i);
+    }
 }
 
 static void PrintDeviceInfo(ALCdevice *device)
@@ -618,84 +839,106 @@ static void FadeInOutMono8(byte *data, ALsizei size, ALsizei freq)
     }
 }
 
-boolean I_OAL_CacheSound(sfxinfo_t *sfx)
+typedef struct
 {
+    sfxinfo_t *sfx;
     int lumpnum;
-    byte *lumpdata = NULL, *wavdata = NULL;
+    int lumplen;
+    byte *lumpdata;
+    byte *wavdata;
+    byte *sampledata;
+    ALsizei size, freq;
+    ALenum format;
+    boolean decoded;
+    boolean badfile;
+    sndfile_error_t error; // printed by UploadSound
+} sfxjob_t;
+
+// Decode a sound lump into raw samples. This neither touches the zone memory
+// allocator nor the OpenAL context and doesn't print, so it may run on a
+// worker thread.
+
+static void DecodeSound(sfxjob_t *job)
+{
+    byte *lumpdata = job->lumpdata;
+    int lumplen = job->lumplen;
 
-    if (!oal)
+    // Check the header, and ensure this is a valid sound
+    if (lumplen > DMXHDRSIZE && lumpdata[0] == 0x03 && lumpdata[1] == 0x00)
     {
-        return false;
-    }
+        ALsizei freq = (lumpdata[3] << 8) | lumpdata[2];
+        ALsizei size = (lumpdata[7] << 24) | (lumpdata[6] << 16)
+                       | (lumpdata[5] << 8) | lumpdata[4];
 
-    lumpnum = I_GetSfxLumpNum(sfx);
+        // Don't play sounds that think they're longer than they really are,
+        // only contain padding, or are shorter than the padding size.
+        if (size > lumplen - DMXHDRSIZE || size <= DMXPADSIZE * 2)
+        {
+            return;
+        }
 
-    if (lumpnum < 0)
-    {
-        return false;
-    }
+        byte *sampledata = lumpdata + DMXHDRSIZE;
+
+        // DMX skips the first and last 16 bytes of data. Custom sounds may
+        // be created with tools that aren't aware of this, which means part
+        // of the waveform is cut off. We compensate for this by fading in
+        // or out sounds that start or end at a non-zero amplitude to
+        // prevent clicking.
+        // Reference: https://www.doomworld.com/forum/post/949486
+        sampledata += DMXPADSIZE;
+        size -= DMXPADSIZE * 2;
+        if (!job->sfx->looping)
+        {
+            FadeInOutMono8(sampledata, size, freq);
+        }
 
-    // haleyjd 06/03/06: rewrote again to make sound data properly freeable
-    while (sfx->cached == false)
+        job->sampledata = sampledata;
+        job->size = size;
+        job->freq = freq;
+
+        // All Doom sounds are 8-bit
+        job->format = AL_FORMAT_MONO8;
+    }
+    else
     {
-        byte *sampledata;
-        int lumplen;
+        job->size = lumplen;
 
-        ALsizei size, freq;
-        ALenum format;
-        ALuint buffer;
+        if (!I_SND_LoadFile(lumpdata, &job->format, &job->wavdata, &job->size,
+                            &job->freq, job->sfx->looping, &job->error))
+        {
+            job->badfile = true;
+            return;
+        }
 
-        // haleyjd: this should always be called (if lump is already loaded,
-        // W_CacheLumpNum handles that for us).
-        lumpdata = (byte *)W_CacheLumpNum(lumpnum, PU_STATIC);
+        job->sampledata = job->wavdata;
+    }
 
-        lumplen = W_LumpLength(lumpnum);
+    job->decoded = true;
+}
 
-        // Check the header, and ensure this is a valid sound
-        if (lumplen > DMXHDRSIZE && lumpdata[0] == 0x03 && lumpdata[1] == 0x00)
-        {
-            freq = (lumpdata[3] << 8) | lumpdata[2];
-            size = (lumpdata[7] << 24) | (lumpdata[6] << 16)
-                   | (lumpdata[5] << 8) | lumpdata[4];
+// Upload decoded samples into an OpenAL buffer and release the job's memory.
+// Must run on the main thread.
 
-            // Don't play sounds that think they're longer than they really are,
-            // only contain padding, or are shorter than the padding size.
-            if (size > lumplen - DMXHDRSIZE || size <= DMXPADSIZE * 2)
-            {
-                break;
-            }
+static boolean UploadSound(sfxjob_t *job)
+{
+    sfxinfo_t *sfx = job->sfx;
 
-            sampledata = lumpdata + DMXHDRSIZE;
-
-            // DMX skips the first and last 16 bytes of data. Custom sounds may
-            // be created with tools that aren't aware of this, which means part
-            // of the waveform is cut off. We compensate for this by fading in
-            // or out sounds that start or end at a non-zero amplitude to
-            // prevent clicking.
-            // Reference: https://www.doomworld.com/forum/post/949486
-            sampledata += DMXPADSIZE;
-            size -= DMXPADSIZE * 2;
-            if (!sfx->looping)
-            {
-                FadeInOutMono8(sampledata, size, freq);
-            }
+    while (sfx->cached == false)
+    {
+        ALuint buffer;
 
-            // All Doom sounds are 8-bit
-            format = AL_FORMAT_MONO8;
-        }
-        else
+        if (!job->decoded)
         {
-            size = lumplen;
-
-            if (!I_SND_LoadFile(lumpdata, &format, &wavdata, &size, &freq,
-                                sfx->looping))
+            if (job->error.message[0])
+            {
+                I_Printf(job->error.verbosity, "%s", job->error.message);
+            }
+            if (job->badfile)
             {
                 I_Printf(VB_WARNING, " I_OAL_CacheSound: %s",
-                         lumpinfo[lumpnum].name);
-                break;
+                         lumpinfo[job->lumpnum].name);
             }
-
-            sampledata = wavdata;
+            break;
         }
 
         alGetError();
@@ -705,7 +948,8 @@ boolean I_OAL_CacheSound(sfxinfo_t *sfx)
             I_Printf(VB_ERROR, "I_OAL_CacheSound: Error creating buffers.");
             break;
         }
-        alBufferData(buffer, format, sampledata, size, freq);
+        alBufferData(buffer, job->format, job->sampledata, job->size,
+                     job->freq);
         if (alGetError() != AL_NO_ERROR)
         {
             I_Printf(VB_ERROR, "I_OAL_CacheSound: Error buffering data.");
@@ -714,11 +958,10 @@ boolean I_OAL_CacheSound(sfxinfo_t *sfx)
 
         sfx->buffer = buffer;
         sfx->cached = true;
+        sfx->length = GetSoundLength(sfx->buffer);
 
         if (sfx->ambient)
         {
-            sfx->length = GetSoundLength(sfx->buffer);
-
             if ((uint64_t)(sfx->length * FRACUNIT) > INT_MAX)
             {
                 // Ignore ambient sounds that are somehow over 32767.99998474
@@ -727,17 +970,17 @@ boolean I_OAL_CacheSound(sfxinfo_t *sfx)
             }
         }
 
-        I_CacheRumble(sfx, format, sampledata, size, freq);
+        I_CacheRumble(sfx, job->format, job->sampledata, job->size, job->freq);
     }
 
     // don't need original lump data any more
-    if (lumpdata)
+    if (job->lumpdata)
     {
-        Z_Free(lumpdata);
+        Z_Free(job->lumpdata);
     }
-    if (wavdata)
+    if (job->wavdata)
     {
-        free(wavdata);
+        free(job->wavdata);
     }
 
     if (sfx->cached == false)
@@ -749,6 +992,154 @@ boolean I_OAL_CacheSound(sfxinfo_t *sfx)
     return true;
 }
 
+static boolean PrepareSound(sfxjob_t *job, sfxinfo_t *sfx)
+{
+    const int lumpnum = I_GetSfxLumpNum(sfx);
+
+    if (lumpnum < 0)
+    {
+        return false;
+    }
+
+    memset(job, 0, sizeof(*job));
+    job->sfx = sfx;
+    job->lumpnum = lumpnum;
+    job->lumplen = W_LumpLength(lumpnum);
+
+    // haleyjd: this should always be called (if lump is already loaded,
+    // W_CacheLumpNum handles that for us).
+    job->lumpdata = W_CacheLumpNum(lumpnum, PU_STATIC);
+
+    return true;
+}
+
+boolean I_OAL_CacheSound(sfxinfo_t *sfx)
+{
+    sfxjob_t job;
+
+    if (!oal)
+    {
+        return false;
+    }
+
+    if (I_GetSfxLumpNum(sfx) < 0)
+    {
+        return false;
+    }
+
+    // haleyjd 06/03/06: rewrote again to make sound data properly freeable
+    if (sfx->cached)
+    {
+        return true;
+    }
+
+    PrepareSound(&job, sfx);
+
+    DecodeSound(&job);
+
+    return UploadSound(&job);
+}
+
+// Parallel sound precaching. Decoding (libsndfile for WAV/OGG/FLAC
+// replacements) is spread across worker threads, only the upload into
+// OpenAL buffers happens on the main thread.
+
+#define MAX_DECODE_THREADS 16
+
+static sfxjob_t *decode_jobs;
+static SDL_AtomicInt decode_next;
+
+static int DecodeThread(void *unused)
+{
+    while (true)
+    {
+        const int i = SDL_AddAtomicInt(&decode_next, 1);
+
+        if (i >= array_size(decode_jobs))
+        {
+            break;
+        }
+
+        DecodeSound(&decode_jobs[i]);
+    }
+
+    return 0;
+}
+
+void I_OAL_CacheSounds(sfxinfo_t **sfx, int num_sfx)
+{
+    SDL_Thread *threads[MAX_DECODE_THREADS];
+    int num_threads;
+    byte *hitlist;
+
+    if (!oal || num_sfx <= 0)
+    {
+        return;
+    }
+
+    // Several sfx may share a lump, but each job modifies and frees its lump
+    // data. Decode only the first user of a lump in parallel and leave the
+    // others to the serial pass below.
+    hitlist = Z_Calloc(numlumps, 1, PU_STATIC, NULL);
+
+    for (int i = 0; i < num_sfx; i++)
+    {
+        sfxjob_t job;
+
+        if (sfx[i]->cached || I_GetSfxLumpNum(sfx[i]) < 0
+            || hitlist[sfx[i]->lumpnum])
+        {
+            continue;
+        }
+
+        hitlist[sfx[i]->lumpnum] = 1;
+
+        if (PrepareSound(&job, sfx[i]))
+        {
+            array_push(decode_jobs, job);
+        }
+    }
+
+    Z_Free(hitlist);
+
+    num_threads = SDL_GetNumLogicalCPUCores();
+    num_threads = CLAMP(num_threads, 1, MAX_DECODE_THREADS);
+    num_threads = MIN(num_threads, array_size(decode_jobs));
+
+    SDL_SetAtomicInt(&decode_next, 0);
+
+    // The main thread takes part in decoding as well.
+    for (int i = 1; i < num_threads; i++)
+    {
+        threads[i] = SDL_CreateThread(DecodeThread, "sfx decoder", NULL);
+    }
+
+    DecodeThread(NULL);
+
+    for (int i = 1; i < num_threads; i++)
+    {
+        if (threads[i])
+        {
+            SDL_WaitThread(threads[i], NULL);
+        }
+    }
+
+    // Upload in sfx order, decoding errors are printed here on the main
+    // thread.
+    sfxjob_t *job;
+    array_foreach(job, decode_jobs)
+    {
+        UploadSound(job);
+    }
+
+    array_free(decode_jobs);
+
+    for (int i = 0; i < num_sfx; i++)
+    {
+        I_OAL_CacheSound(sfx[i]);
+    }
+}
+
 float I_OAL_GetOffset(int channel)
 {
     float offset;
@@ -777,9 +1168,16 @@ boolean I_OAL_StartSound(int channel, sfxinfo_t *sfx, const sfxparams_t *params)
     }
 
     alSourcei(oal->sources[channel], AL_BUFFER, sfx->buffer);
-    alSourcei(oal->sources[channel], AL_LOOPING, sfx->looping);
-    alSourcef(oal->sources[channel], AL_PITCH, params->pitch);
-    alSourcef(oal->sources[channel], AL_SEC_OFFSET, params->offset);
+    SetScalar(channel, SRC_LOOPING, sfx->looping);
+    SetScalar(channel, SRC_PITCH, params->pitch);
+
+    // The offset is reset with the buffer.
+    if (params->offset > 0.0f)
+    {
+        alSourcef(oal->sources[channel], AL_SEC_OFFSET, params->offset);
+    }
+
+    CommitSource(channel);
 
     alGetError();
     alSourcePlay(oal->sources[channel]);
@@ -864,7 +1262,7 @@ void I_OAL_SetGain(int channel, float gain)
         return;
     }
 
-    alSourcef(oal->sources[channel], AL_GAIN, (ALfloat)gain);
+    SetScalar(channel, SRC_GAIN, (ALfloat)gain);
 }
 
 void I_OAL_SetVolume(int channel, int volume)
@@ -874,7 +1272,7 @@ void I_OAL_SetVolume(int channel, int volume)
         return;
     }
 
-    alSourcef(oal->sources[channel], AL_GAIN, VOL_TO_GAIN(volume));
+    SetScalar(channel, SRC_GAIN, VOL_TO_GAIN(volume));
 }
 
 void I_OAL_SetPan(int channel, int separation)
@@ -891,6 +1289,5 @@ void I_OAL_SetPan(int channel, int separation)
     // the circular shape of the sound field along the z-axis. The end result
     // is perceived to move in a straight line along the x-axis only (panning).
     pan = (ALfloat)separation / 255.0f - 0.5f;
-    alSource3f(oal->sources[channel], AL_POSITION, pan, 0.0f,
-               -sqrtf(1.0f - pan * pan));
+    SetVector(channel, SRC_POSITION, pan, 0.0f, -sqrtf(1.0f - pan * pan));
 }
@@ -60,6 +60,8 @@ boolean I_OAL_AllowReinitSound(void);
 
 boolean I_OAL_CacheSound(struct sfxinfo_s *sfx);
 
+void I_OAL_CacheSounds(struct sfxinfo_s **sfx, int num_sfx);
+
 float I_OAL_GetOffset(int channel);
 
 boolean I_OAL_StartSound(int channel, struct sfxinfo_s *sfx,
@@ -16,6 +16,8 @@
 //   System interface for music.
 //
 
+#include <SDL3/SDL.h>
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -106,15 +108,6 @@ typedef struct
 
 } opl_channel_data_t;
 
-// Data associated with a track that is currently playing.
-
-typedef struct
-{
-    // Track iterator used to read new events.
-
-    midi_track_iter_t *iter;
-} opl_track_data_t;
-
 typedef struct opl_voice_s opl_voice_t;
 
 struct opl_voice_s
@@ -340,9 +333,11 @@ static int num_opl_voices;
 
 static opl_channel_data_t channels[MIDI_CHANNELS_PER_TRACK];
 
-// Track data for playing tracks:
+// Events of the playing song, merged from all tracks:
 
-static opl_track_data_t *tracks;
+static const midi_stream_event_t *stream;
+static unsigned int num_stream_events;
+static unsigned int stream_pos;
 static unsigned int num_tracks = 0;
 static unsigned int running_tracks = 0;
 static boolean song_looping;
@@ -370,6 +365,46 @@ int num_opl_chips = 1;
 
 static boolean opl_stereo_correct = false;
 
+// Render-ahead: the song is synthesized on a background thread and the
+// stream only copies PCM. Songs that fit in opl_render_cache are kept, so
+// playing them again costs nothing.
+
+#define RENDER_CHUNK  4096                 // frames
+#define RENDER_WINDOW (OPL_SAMPLE_RATE * 2) // look-ahead when not caching
+#define RENDER_TAIL   (OPL_SAMPLE_RATE * 2) // release after a song ends
+
+typedef struct
+{
+    uint64_t key;
+    short **chunks;   // m_array of RENDER_CHUNK frame blocks
+    uint64_t frames;
+    uint64_t loop_start, loop_end;
+    boolean looping;
+    boolean complete; // all frames rendered, loop points known
+    boolean windowed; // too long to cache, consumed chunks are freed
+} render_song_t;
+
+static boolean opl_render_ahead;
+static int opl_render_cache;
+
+static int opl_device;
+static uint64_t song_key;
+
+static render_song_t **render_cache; // m_array, least recently used first
+static render_song_t *render_song;
+static boolean render_cached;
+
+static SDL_Thread *render_thread;
+static SDL_Mutex *render_mutex;
+static SDL_Condition *render_cond;
+static boolean render_quit;
+static uint64_t render_readpos;
+
+// Sample positions of song restarts, written on the render thread.
+
+static uint64_t render_restarts[2];
+static int num_render_restarts;
+
 // Load instrument table from GENMIDI lump:
 
 static byte *lump;
@@ -687,8 +722,7 @@ static void VoiceKeyOff(opl_voice_t *voice)
                       voice->freq >> 8);
 }
 
-static opl_channel_data_t *TrackChannelForEvent(opl_track_data_t *track,
-                                                midi_event_t *event)
+static opl_channel_data_t *TrackChannelForEvent(midi_event_t *event)
 {
     unsigned int channel_num = event->data.channel.channel;
 
@@ -709,13 +743,13 @@ static opl_channel_data_t *TrackChannelForEvent(opl_track_data_t *track,
 
 // Get the frequency that we should be using for a voice.
 
-static void KeyOffEvent(opl_track_data_t *track, midi_event_t *event)
+static void KeyOffEvent(midi_event_t *event)
 {
     opl_channel_data_t *channel;
     int i;
     unsigned int key;
 
-    channel = TrackChannelForEvent(track, event);
+    channel = TrackChannelForEvent(event);
     key = event->data.channel.param1;
 
     // Turn off voices being used to play this key.
@@ -964,7 +998,7 @@ static void VoiceKeyOn(opl_channel_data_t *channel, genmidi_instr_t *instrument,
     UpdateVoiceFrequency(voice);
 }
 
-static void KeyOnEvent(opl_track_data_t *track, midi_event_t *event)
+static void KeyOnEvent(midi_event_t *event)
 {
     genmidi_instr_t *instrument;
     opl_channel_data_t *channel;
@@ -980,12 +1014,12 @@ static void KeyOnEvent(opl_track_data_t *track, midi_event_t *event)
     // key off.
     if (volume <= 0)
     {
-        KeyOffEvent(track, event);
+        KeyOffEvent(event);
         return;
     }
 
     // The channel.
-    channel = TrackChannelForEvent(track, event);
+    channel = TrackChannelForEvent(event);
 
     // Percussion channel is treated differently.
     if (event->data.channel.channel == 9)
@@ -1071,14 +1105,14 @@ static void KeyOnEvent(opl_track_data_t *track, midi_event_t *event)
     }
 }
 
-static void ProgramChangeEvent(opl_track_data_t *track, midi_event_t *event)
+static void ProgramChangeEvent(midi_event_t *event)
 {
     opl_channel_data_t *channel;
     int instrument;
 
     // Set the instrument used on this channel.
 
-    channel = TrackChannelForEvent(track, event);
+    channel = TrackChannelForEvent(event);
     instrument = event->data.channel.param1;
     channel->instrument = &main_instrs[instrument];
 
@@ -1177,13 +1211,13 @@ static void AllNotesOff(opl_channel_data_t *channel, unsigned int param)
     }
 }
 
-static void ControllerEvent(opl_track_data_t *track, midi_event_t *event)
+static void ControllerEvent(midi_event_t *event)
 {
     opl_channel_data_t *channel;
     unsigned int controller;
     unsigned int param;
 
-    channel = TrackChannelForEvent(track, event);
+    channel = TrackChannelForEvent(event);
     controller = event->data.channel.param1;
     param = event->data.channel.param2;
 
@@ -1209,7 +1243,7 @@ static void ControllerEvent(opl_track_data_t *track, midi_event_t *event)
 
 // Process a pitch bend event.
 
-static void PitchBendEvent(opl_track_data_t *track, midi_event_t *event)
+static void PitchBendEvent(midi_event_t *event)
 {
     opl_channel_data_t *channel;
     int i;
@@ -1221,7 +1255,7 @@ static void PitchBendEvent(opl_track_data_t *track, midi_event_t *event)
     // Update the channel bend value.  Only the MSB of the pitch bend
     // value is considered: this is what Doom does.
 
-    channel = TrackChannelForEvent(track, event);
+    channel = TrackChannelForEvent(event);
     channel->bend = event->data.channel.param2 - 64;
 
     // Update all voices for this channel.
@@ -1259,7 +1293,7 @@ static void MetaSetTempo(unsigned int tempo)
 
 // Process a meta event.
 
-static void MetaEvent(opl_track_data_t *track, midi_event_t *event)
+static void MetaEvent(midi_event_t *event)
 {
     byte *data = event->data.meta.data;
     unsigned int data_len = event->data.meta.length;
@@ -1286,8 +1320,7 @@ static void MetaEvent(opl_track_data_t *track, midi_event_t *event)
             }
             break;
 
-        // End of track - actually handled when we run out of events in the
-        // track, see below.
+        // End of track - counted in EventTimerCallback.
 
         case MIDI_META_END_OF_TRACK:
             break;
@@ -1301,32 +1334,32 @@ static void MetaEvent(opl_track_data_t *track, midi_event_t *event)
 
 // Process a MIDI event from a track.
 
-static void ProcessEvent(opl_track_data_t *track, midi_event_t *event)
+static void ProcessEvent(midi_event_t *event)
 {
     switch (event->event_type)
     {
         case MIDI_EVENT_NOTE_OFF:
-            KeyOffEvent(track, event);
+            KeyOffEvent(event);
             break;
 
         case MIDI_EVENT_NOTE_ON:
-            KeyOnEvent(track, event);
+            KeyOnEvent(event);
             break;
 
         case MIDI_EVENT_CONTROLLER:
-            ControllerEvent(track, event);
+            ControllerEvent(event);
             break;
 
         case MIDI_EVENT_PROGRAM_CHANGE:
-            ProgramChangeEvent(track, event);
+            ProgramChangeEvent(event);
             break;
 
         case MIDI_EVENT_PITCH_BEND:
-            PitchBendEvent(track, event);
+            PitchBendEvent(event);
             break;
 
         case MIDI_EVENT_META:
-            MetaEvent(track, event);
+            MetaEvent(event);
             break;
 
         // SysEx events can be ignored.
@@ -1341,7 +1374,7 @@ static void ProcessEvent(opl_track_data_t *track, midi_event_t *event)
     }
 }
 
-static void ScheduleTrack(opl_track_data_t *track);
+static void ScheduleEvent(unsigned int nticks);
 static void InitChannel(opl_channel_data_t *channel);
 
 // Restart a song from the beginning.
@@ -1350,15 +1383,17 @@ static void RestartSong(void *unused)
 {
     unsigned int i;
 
+    if (render_song && num_render_restarts < arrlen(render_restarts))
+    {
+        render_restarts[num_render_restarts++] = OPL_GetSamplePosition();
+    }
+
     running_tracks = num_tracks;
 
     start_music_volume = current_music_volume;
 
-    for (i = 0; i < num_tracks; ++i)
-    {
-        MIDI_RestartIterator(tracks[i].iter);
-        ScheduleTrack(&tracks[i]);
-    }
+    stream_pos = 0;
+    ScheduleEvent(stream[0].time);
 
     for (i = 0; i < MIDI_CHANNELS_PER_TRACK; ++i)
     {
@@ -1366,30 +1401,33 @@ static void RestartSong(void *unused)
     }
 }
 
-// Callback function invoked when another event needs to be read from
-// a track.
+// Callback function invoked when the next events of the song are due.
 
-static void TrackTimerCallback(void *arg)
+static void EventTimerCallback(void *unused)
 {
-    opl_track_data_t *track = arg;
-    midi_event_t *event;
+    const unsigned int time = stream[stream_pos].time;
 
-    // Get the next event and process it.
+    // Process all events for this point in time.
 
-    if (!MIDI_GetNextEvent(track->iter, &event))
+    while (stream_pos < num_stream_events && stream[stream_pos].time == time)
     {
-        return;
-    }
+        midi_event_t *event = stream[stream_pos++].event;
 
-    ProcessEvent(track, event);
+        ProcessEvent(event);
 
-    // End of track?
+        if (event->event_type == MIDI_EVENT_META
+            && event->data.meta.type == MIDI_META_END_OF_TRACK)
+        {
+            --running_tracks;
+        }
+    }
 
-    if (event->event_type == MIDI_EVENT_META
-        && event->data.meta.type == MIDI_META_END_OF_TRACK)
+    if (stream_pos < num_stream_events)
+    {
+        ScheduleEvent(stream[stream_pos].time - time);
+    }
+    else if (song_looping)
     {
-        --running_tracks;
-
         // When all tracks have finished, restart the song.
         // Don't restart the song immediately, but wait for 5ms
         // before triggering a restart.  Otherwise it is possible
@@ -1397,33 +1435,22 @@ static void TrackTimerCallback(void *arg)
         // to lock up in an infinite loop. (5ms should be short
         // enough not to be noticeable by the listener).
 
-        if (running_tracks <= 0 && song_looping)
-        {
-            OPL_SetCallback(5000, RestartSong, NULL);
-        }
-
-        return;
+        OPL_SetCallback(5000, RestartSong, NULL);
     }
-
-    // Reschedule the callback for the next event in the track.
-
-    ScheduleTrack(track);
 }
 
-static void ScheduleTrack(opl_track_data_t *track)
+static void ScheduleEvent(unsigned int nticks)
 {
-    unsigned int nticks;
     uint64_t us;
 
     // Get the number of microseconds until the next event.
 
-    nticks = MIDI_GetDeltaTime(track->iter);
     us = ((uint64_t)nticks * us_per_beat) / ticks_per_beat;
 
     // Set a timer to be invoked when the next event is
     // ready to play.
 
-    OPL_SetCallback(us, TrackTimerCallback, track);
+    OPL_SetCallback(us, EventTimerCallback, NULL);
 }
 
 // Initialize a channel.
@@ -1443,18 +1470,294 @@ static void InitChannel(opl_channel_data_t *channel)
     channel->bend = 0;
 }
 
-// Start a MIDI track playing:
+static uint64_t SongKey(const byte *data, int size)
+{
+    // FNV-1a over the song and everything that changes the output.
+    const int params[] = {opl_device, num_opl_chips, opl_opl3mode,
+                          opl_stereo_correct, opl_drv_ver};
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (int i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+
+    for (int i = 0; i < arrlen(params); ++i)
+    {
+        hash = (hash ^ params[i]) * 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static size_t SongBytes(const render_song_t *song)
+{
+    return array_size(song->chunks) * RENDER_CHUNK * 2 * sizeof(short);
+}
+
+static void FreeSong(render_song_t *song)
+{
+    for (int i = 0; i < array_size(song->chunks); ++i)
+    {
+        free(song->chunks[i]);
+    }
+    array_free(song->chunks);
+    free(song);
+}
 
-static void StartTrack(midi_file_t *file, unsigned int track_num)
+static void StoreSong(render_song_t *song)
 {
-    opl_track_data_t *track;
+    size_t total = SongBytes(song);
+
+    for (int i = 0; i < array_size(render_cache); ++i)
+    {
+        total += SongBytes(render_cache[i]);
+    }
 
-    track = &tracks[track_num];
-    track->iter = MIDI_IterateTrack(file, track_num);
+    while (array_size(render_cache)
+           && total > (size_t)opl_render_cache * 1024 * 1024)
+    {
+        total -= SongBytes(render_cache[0]);
+        FreeSong(render_cache[0]);
+        array_delete(render_cache, 0);
+    }
 
-    // Schedule the first event.
+    array_push(render_cache, song);
+}
+
+static render_song_t *FindSong(uint64_t key, boolean looping)
+{
+    for (int i = 0; i < array_size(render_cache); ++i)
+    {
+        render_song_t *song = render_cache[i];
+
+        if (song->key == key && song->looping == looping)
+        {
+            // Move to the most recently used end.
+            array_delete(render_cache, i);
+            array_push(render_cache, song);
+            return song;
+        }
+    }
+
+    return NULL;
+}
+
+// Called with render_mutex held after a chunk has been added.
+
+static void UpdateRenderedSong(render_song_t *song, uint64_t start,
+                               uint64_t *tail_end)
+{
+    if (!song->windowed
+        && SongBytes(song) > (size_t)opl_render_cache * 1024 * 1024)
+    {
+        song->windowed = true;
+    }
+
+    if (song->windowed)
+    {
+        return;
+    }
+
+    if (song->looping && num_render_restarts == 2)
+    {
+        song->loop_start = render_restarts[0] - start;
+        song->loop_end = render_restarts[1] - start;
+        song->frames = song->loop_end;
+        song->complete = true;
+
+        // Drop the chunks rendered past the end of the loop.
+        while (array_size(song->chunks) * RENDER_CHUNK
+               >= song->frames + RENDER_CHUNK)
+        {
+            free(array_pop(song->chunks));
+        }
+    }
+    else if (!song->looping && running_tracks == 0)
+    {
+        if (!*tail_end)
+        {
+            *tail_end = song->frames + RENDER_TAIL;
+        }
+        else if (song->frames >= *tail_end)
+        {
+            song->complete = true;
+        }
+    }
+}
+
+static int RenderThread(void *data)
+{
+    render_song_t *song = data;
+    const uint64_t start = OPL_GetSamplePosition();
+    uint64_t tail_end = 0;
+    int freed = 0;
+
+    while (true)
+    {
+        SDL_LockMutex(render_mutex);
 
-    ScheduleTrack(track);
+        while (!render_quit && song->windowed
+               && song->frames - render_readpos >= RENDER_WINDOW)
+        {
+            SDL_WaitCondition(render_cond, render_mutex);
+        }
+
+        if (song->windowed)
+        {
+            for (; freed < render_readpos / RENDER_CHUNK; ++freed)
+            {
+                free(song->chunks[freed]);
+                song->chunks[freed] = NULL;
+            }
+        }
+
+        const boolean quit = render_quit || song->complete;
+
+        SDL_UnlockMutex(render_mutex);
+
+        if (quit)
+        {
+            break;
+        }
+
+        short *chunk = malloc(RENDER_CHUNK * 2 * sizeof(short));
+        OPL_FillBuffer((byte *)chunk, RENDER_CHUNK);
+
+        SDL_LockMutex(render_mutex);
+        array_push(song->chunks, chunk);
+        song->frames += RENDER_CHUNK;
+        UpdateRenderedSong(song, start, &tail_end);
+        SDL_SignalCondition(render_cond);
+        SDL_UnlockMutex(render_mutex);
+    }
+
+    return 0;
+}
+
+static boolean StartRenderThread(boolean looping)
+{
+    if (!render_mutex)
+    {
+        render_mutex = SDL_CreateMutex();
+        render_cond = SDL_CreateCondition();
+    }
+
+    if (!render_mutex || !render_cond)
+    {
+        return false;
+    }
+
+    render_readpos = 0;
+    render_quit = false;
+    num_render_restarts = 0;
+
+    render_song = FindSong(song_key, looping);
+    if (render_song)
+    {
+        render_cached = true;
+        return true;
+    }
+
+    render_song = calloc(1, sizeof(*render_song));
+    render_song->key = song_key;
+    render_song->looping = looping;
+    render_song->windowed = (opl_render_cache == 0);
+    render_cached = false;
+
+    render_thread = SDL_CreateThread(RenderThread, "opl render", render_song);
+    if (!render_thread)
+    {
+        FreeSong(render_song);
+        render_song = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+static void StopRenderThread(void)
+{
+    if (render_thread)
+    {
+        SDL_LockMutex(render_mutex);
+        render_quit = true;
+        SDL_SignalCondition(render_cond);
+        SDL_UnlockMutex(render_mutex);
+
+        SDL_WaitThread(render_thread, NULL);
+        render_thread = NULL;
+    }
+
+    if (render_song && !render_cached)
+    {
+        if (render_song->complete && !render_song->windowed)
+        {
+            StoreSong(render_song);
+        }
+        else
+        {
+            FreeSong(render_song);
+        }
+    }
+
+    render_song = NULL;
+}
+
+static int ReadRenderedSong(byte *buffer, int buffer_samples)
+{
+    render_song_t *song = render_song;
+    short *out = (short *)buffer;
+    int filled = 0;
+
+    SDL_LockMutex(render_mutex);
+
+    while (filled < buffer_samples)
+    {
+        uint64_t pos = render_readpos;
+        uint64_t limit = song->frames;
+
+        if (song->complete && song->looping
+            && song->loop_end > song->loop_start)
+        {
+            if (pos >= song->loop_end)
+            {
+                pos = song->loop_start
+                      + (pos - song->loop_start)
+                            % (song->loop_end - song->loop_start);
+            }
+            limit = song->loop_end;
+        }
+        else if (pos >= song->frames)
+        {
+            if (song->complete)
+            {
+                // Silence after the end, like the emulator would produce.
+                memset(out + filled * 2, 0,
+                       (buffer_samples - filled) * 2 * sizeof(short));
+                render_readpos += buffer_samples - filled;
+                break;
+            }
+
+            SDL_WaitCondition(render_cond, render_mutex);
+            continue;
+        }
+
+        const int offset = pos % RENDER_CHUNK;
+        int n = MIN(buffer_samples - filled, RENDER_CHUNK - offset);
+        n = MIN(n, limit - pos);
+
+        memcpy(out + filled * 2, song->chunks[pos / RENDER_CHUNK] + offset * 2,
+               n * 2 * sizeof(short));
+
+        filled += n;
+        render_readpos += n;
+    }
+
+    SDL_SignalCondition(render_cond);
+    SDL_UnlockMutex(render_mutex);
+
+    return buffer_samples;
 }
 
 static boolean I_OPL_InitStream(int device)
@@ -1462,6 +1765,8 @@ static boolean I_OPL_InitStream(int device)
     char *dmxoption;
     opl_init_result_t chip_type;
 
+    opl_device = device;
+
     chip_type = OPL_Init(opl_io_port, num_opl_chips);
     if (chip_type == OPL_INIT_NONE)
     {
@@ -1508,7 +1813,7 @@ static boolean I_OPL_InitStream(int device)
 
     InitVoices();
 
-    tracks = NULL;
+    stream = NULL;
     num_tracks = 0;
     music_initialized = true;
 
@@ -1570,6 +1875,8 @@ static boolean I_OPL_OpenStream(void *data, ALsizei size, ALenum *format,
         return false;
     }
 
+    song_key = SongKey(data, size);
+
     *format = AL_FORMAT_STEREO16;
     *freq = OPL_SAMPLE_RATE;
     *frame_size = 2 * sizeof(short);
@@ -1590,9 +1897,8 @@ static void I_OPL_PlayStream(boolean looping)
 
     I_OPL_SetMusicVolume(127);
 
-    // Allocate track data.
-
-    tracks = malloc(MIDI_NumTracks(midifile) * sizeof(opl_track_data_t));
+    stream = MIDI_GetEventStream(midifile, &num_stream_events);
+    stream_pos = 0;
 
     num_tracks = MIDI_NumTracks(midifile);
     running_tracks = num_tracks;
@@ -1607,19 +1913,28 @@ static void I_OPL_PlayStream(boolean looping)
 
     start_music_volume = current_music_volume;
 
-    for (i = 0; i < num_tracks; ++i)
-    {
-        StartTrack(midifile, i);
-    }
+    // Schedule the first event.
+
+    ScheduleEvent(stream[0].time);
 
     for (i = 0; i < MIDI_CHANNELS_PER_TRACK; ++i)
     {
         InitChannel(&channels[i]);
     }
+
+    if (opl_render_ahead)
+    {
+        StartRenderThread(looping);
+    }
 }
 
 static int I_OPL_FillStream(byte *buffer, int buffer_samples)
 {
+    if (render_song)
+    {
+        return ReadRenderedSong(buffer, buffer_samples);
+    }
+
     return OPL_FillBuffer(buffer, buffer_samples);
 }
 
@@ -1632,6 +1947,8 @@ static void I_OPL_CloseStream(void)
         return;
     }
 
+    StopRenderThread();
+
     // Stop all playback.
 
     OPL_ClearCallbacks();
@@ -1643,16 +1960,8 @@ static void I_OPL_CloseStream(void)
         AllNotesOff(&channels[i], 0);
     }
 
-    // Free all track data.
-
-    for (i = 0; i < num_tracks; ++i)
-    {
-        MIDI_FreeIterator(tracks[i].iter);
-    }
-
-    free(tracks);
-
-    tracks = NULL;
+    stream = NULL;
+    num_stream_events = 0;
     num_tracks = 0;
 
     if (midifile)
@@ -1668,6 +1977,12 @@ static void I_OPL_ShutdownStream(void)
 {
     if (music_initialized)
     {
+        for (int i = 0; i < array_size(render_cache); ++i)
+        {
+            FreeSong(render_cache[i]);
+        }
+        array_free(render_cache);
+
         OPL_Shutdown();
 
         // Release GENMIDI lump
@@ -1701,6 +2016,10 @@ static void I_OPL_BindVariables(void)
         "[OPL3 Emulation] Number of chips to emulate (1-6)");
     BIND_BOOL_MUSIC(opl_stereo_correct, false,
         "[OPL3 Emulation] Use MIDI-correct stereo channel polarity");
+    BIND_BOOL_MUSIC(opl_render_ahead, false,
+        "[OPL3 Emulation] Render music ahead on a background thread");
+    BIND_NUM_MUSIC(opl_render_cache, 256, 0, 2048,
+        "[OPL3 Emulation] Memory for rendered songs in MiB (0 = no caching)");
 }
 
 stream_module_t stream_opl_module =
@@ -407,7 +407,8 @@ static void CloseFile(sndfile_t *file)
     }
 }
 
-static boolean OpenFile(sndfile_t *file, void *data, sf_count_t size)
+static boolean OpenFile(sndfile_t *file, void *data, sf_count_t size,
+                        sndfile_error_t *error)
 {
     sample_format_t sample_format;
     ALenum format;
@@ -421,7 +422,9 @@ static boolean OpenFile(sndfile_t *file, void *data, sf_count_t size)
 
     if (!file->sndfile)
     {
-        I_Printf(VB_DEBUG, "SndFile: %s", sf_strerror(file->sndfile));
+        error->verbosity = VB_DEBUG;
+        snprintf(error->message, sizeof(error->message), "SndFile: %s",
+                 sf_strerror(file->sndfile));
         return false;
     }
 
@@ -509,7 +512,9 @@ static boolean OpenFile(sndfile_t *file, void *data, sf_count_t size)
 
     if (format == AL_NONE)
     {
-        I_Printf(VB_ERROR, "SndFile: Unsupported channel count %d.",
+        error->verbosity = VB_ERROR;
+        snprintf(error->message, sizeof(error->message),
+                 "SndFile: Unsupported channel count %d.",
                  file->sfinfo.channels);
         return false;
     }
@@ -578,13 +583,14 @@ static void FadeInOutMonoFloat32(float *data, ALsizei size, ALsizei freq)
 }
 
 boolean I_SND_LoadFile(void *data, ALenum *format, byte **wavdata,
-                       ALsizei *size, ALsizei *freq, boolean looping)
+                       ALsizei *size, ALsizei *freq, boolean looping,
+                       sndfile_error_t *error)
 {
     sndfile_t file = {0};
     sf_count_t num_frames = 0;
     void *local_wavdata = NULL;
 
-    if (OpenFile(&file, data, *size) == false)
+    if (OpenFile(&file, data, *size, error) == false)
     {
         CloseFile(&file);
         return false;
@@ -608,7 +614,9 @@ boolean I_SND_LoadFile(void *data, ALenum *format, byte **wavdata,
 
     if (num_frames < file.sfinfo.frames)
     {
-        I_Printf(VB_ERROR, "sf_readf: %s", sf_strerror(file.sndfile));
+        error->verbosity = VB_ERROR;
+        snprintf(error->message, sizeof(error->message), "sf_readf: %s",
+                 sf_strerror(file.sndfile));
         CloseFile(&file);
         free(local_wavdata);
         return false;
@@ -652,9 +660,14 @@ static boolean I_SND_OpenStream(void *data, ALsizei size, ALenum *format,
                                 ALsizei *freq, ALsizei *frame_size)
 {
     MEMFILE *fs;
+    sndfile_error_t error = {0};
 
-    if (OpenFile(&stream, data, size) == false)
+    if (OpenFile(&stream, data, size, &error) == false)
     {
+        if (error.message[0])
+        {
+            I_Printf(error.verbosity, "%s", error.message);
+        }
         CloseFile(&stream);
         return false;
     }
@@ -22,10 +22,20 @@
 #include "al.h"
 
 #include "doomtype.h"
+#include "i_printf.h"
 
 #define FADETIME 1000 // microseconds
 
+typedef struct
+{
+    verbosity_t verbosity;
+    char message[128];
+} sndfile_error_t;
+
+// Doesn't print, errors are returned in error for the caller to print, so
+// that sounds may be loaded on worker threads.
 boolean I_SND_LoadFile(void *data, ALenum *format, byte **wavdata,
-                       ALsizei *size, ALsizei *freq, boolean looping);
+                       ALsizei *size, ALsizei *freq, boolean looping,
+                       sndfile_error_t *error);
 
 #endif
@@ -29,6 +29,7 @@
 #include "i_rumble.h"
 #include "i_system.h"
 #include "m_array.h"
+#include "m_profile.h"
 #include "mn_menu.h"
 #include "p_mobj.h"
 #include "s_sound.h"
@@ -83,6 +84,7 @@ static channel_info_t channelinfo[MAX_CHANNELS];
 
 boolean snd_ambient, default_snd_ambient;
 boolean snd_limiter;
+boolean snd_virtual_voices;
 int snd_channels_per_sfx;
 int snd_volume_per_sfx;
 
@@ -484,8 +486,41 @@ static void LinkSounds(void)
     }
 }
 
+boolean snd_precache;
+
+boolean I_CacheSound(sfxinfo_t *sfx)
+{
+    if (!snd_init)
+    {
+        return false;
+    }
+
+    return sound_module->CacheSound(sfx);
+}
+
+void I_CacheSounds(sfxinfo_t **sfx, int num_sfx)
+{
+    if (!snd_init)
+    {
+        return;
+    }
+
+    if (sound_module->CacheSounds)
+    {
+        sound_module->CacheSounds(sfx, num_sfx);
+        return;
+    }
+
+    for (int i = 0; i < num_sfx; i++)
+    {
+        sound_module->CacheSound(sfx[i]);
+    }
+}
+
 static void CacheSounds(void)
 {
+    sfxinfo_t **sfx_list = NULL;
+
     // [FG] precache all sound effects
     for (int i = 1; i < num_sfx; i++)
     {
@@ -494,8 +529,21 @@ static void CacheSounds(void)
         {
             continue;
         }
-        sound_module->CacheSound(&S_sfx[i]);
+
+        // Otherwise, sounds are decoded on first use in I_StartSound() and
+        // per level in S_PrecacheLevel(). Look up the lumps anyway, so that
+        // LinkSounds() knows which ones are missing.
+        if (!snd_precache)
+        {
+            I_GetSfxLumpNum(&S_sfx[i]);
+            continue;
+        }
+
+        array_push(sfx_list, &S_sfx[i]);
     }
+
+    I_CacheSounds(sfx_list, array_size(sfx_list));
+    array_free(sfx_list);
 }
 
 //
@@ -530,9 +578,17 @@ void I_InitSound(void)
         return;
     }
 
-    I_Printf(VB_INFO, " Precaching all sound effects... ");
+    if (snd_precache)
+    {
+        I_Printf(VB_INFO, " Precaching all sound effects... ");
+    }
+    M_BeginProfile("CacheSounds");
     CacheSounds();
-    I_Printf(VB_INFO, "done.");
+    M_EndProfile();
+    if (snd_precache)
+    {
+        I_Printf(VB_INFO, "done.");
+    }
     LinkSounds();
 }
 
@@ -803,12 +859,16 @@ void I_BindSoundVariables(void)
     BIND_NUM_SFX(snd_channels, MAX_CHANNELS, 1, MAX_CHANNELS,
         "Number of sound channels");
     BIND_BOOL_SFX(snd_limiter, false, "Use sound output limiter");
+    BIND_BOOL(snd_precache, true,
+        "Precache all sound effects at startup (0 = Decode on first use)");
     BIND_NUM(snd_channels_per_sfx, 5, 0, MAX_CHANNELS,
         "[Limiter] Max number of channels allowed to simultaneously play the "
         "same sound (0 = Off)");
     BIND_NUM(snd_volume_per_sfx, 5 * 100, 0, MAX_CHANNELS * 100,
         "[Limiter] Max volume allowed for a sound that is played "
         "simultaneously by multiple channels [percent] (0 = Off)");
+    BIND_BOOL(snd_virtual_voices, false,
+        "Resume sounds that lost their channel when one becomes free");
     BIND_NUM_GENERAL(snd_module, SND_MODULE_MBF, 0, NUM_SND_MODULES - 1,
         "Sound module (0 = Standard; 1 = OpenAL 3D; 2 = PC Speaker Sound)");
     for (int i = 0; i < arrlen(sound_modules); ++i)
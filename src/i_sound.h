@@ -70,6 +70,8 @@ struct sfxparams_s;
 
 extern boolean snd_ambient, default_snd_ambient;
 extern boolean snd_limiter;
+extern boolean snd_virtual_voices;
+extern boolean snd_precache;
 extern int snd_channels_per_sfx;
 extern int snd_volume_per_sfx;
 
@@ -79,6 +81,7 @@ typedef struct sound_module_s
     boolean (*ReinitSound)(void);
     boolean (*AllowReinitSound)(void);
     boolean (*CacheSound)(struct sfxinfo_s *sfx);
+    void (*CacheSounds)(struct sfxinfo_s **sfx, int num_sfx);
     boolean (*AdjustSoundParams)(const struct mobj_s *listener,
                                  const struct mobj_s *source,
                                  struct sfxparams_s *params);
@@ -123,6 +126,10 @@ void I_SetChannels(void);
 // Get raw data lump index for sound descriptor.
 int I_GetSfxLumpNum(struct sfxinfo_s *sfxinfo);
 
+// Decode and load a sound effect, or a batch of them.
+boolean I_CacheSound(struct sfxinfo_s *sfx);
+void I_CacheSounds(struct sfxinfo_s **sfx, int num_sfx);
+
 // Starts a sound in a particular sound channel.
 int I_StartSound(struct sfxinfo_s *sound, const struct sfxparams_s *params);
 
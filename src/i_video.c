@@ -80,6 +80,11 @@ static boolean default_uncapped;
 int custom_fov;
 
 int fps; // [FG] FPS counter widget
+
+// Frame statistics widget: rolling frame time history and the time spent in
+// the last SDL_RenderPresent() call, in microseconds.
+int frametimes[FRAMETIME_HISTORY], frametime_index;
+int presenttime;
 boolean resetneeded;
 boolean setrefreshneeded;
 boolean toggle_fullscreen;
@@ -106,6 +111,8 @@ static SDL_Surface *argbbuffer;
 static SDL_Palette *palette;
 static SDL_Texture *texture;
 static SDL_Texture *texture_upscaled;
+static SDL_FRect upscaled_rect;
+static int upscaled_width, upscaled_height;
 static SDL_Rect blit_rect = {0};
 
 static int window_x, window_y;
@@ -635,12 +642,12 @@ static void UpdateRender(void)
         // using "nearest" integer scaling.
 
         SDL_SetRenderTarget(renderer, texture_upscaled);
-        SDL_RenderTexture(renderer, texture, &rect, NULL);
+        SDL_RenderTexture(renderer, texture, &rect, &upscaled_rect);
 
         // Finally, render this upscaled texture to screen using linear scaling.
 
         SDL_SetRenderTarget(renderer, NULL);
-        SDL_RenderTexture(renderer, texture_upscaled, NULL, NULL);
+        SDL_RenderTexture(renderer, texture_upscaled, &upscaled_rect, NULL);
     }
     else
     {
@@ -657,7 +664,7 @@ void I_DynamicResolution(void)
 {
     if (!dynamic_resolution || current_video_height <= DRS_MIN_HEIGHT
         || frametime_withoutpresent == 0 || targetrefresh <= 0
-        || menuactive)
+        || menuactive || automap_on)
     {
         return;
     }
@@ -669,83 +676,114 @@ void I_DynamicResolution(void)
         return;
     }
 
-    #define DRS_COOLDOWN_FRAMES 15
+    // The frame time is split into the time spent in R_RenderPlayerView,
+    // which scales with the number of pixels, and the rest of the frame,
+    // which does not. Render time is tracked per pixel and corrected for
+    // the amount of visible geometry of the last frame, so that a sudden
+    // change of the scene is reflected before the averages catch up.
+
+    #define DRS_PRESENT_US    1250 // reserved for SDL render present
+    #define DRS_EMA_ALPHA     0.1
+    #define DRS_DOWNSCALE_T   1.05 // predicted cost over target
+    #define DRS_UPSCALE_T     0.8  // predicted cost under target
+    #define DRS_HEADROOM      0.9  // aim below target after a change
+    #define DRS_STEP          (SCREENHEIGHT / 10)
+    #define DRS_MAX_UPSCALE   (DRS_STEP * 4)
+    #define DRS_COOLDOWN_DOWN 3
+    #define DRS_COOLDOWN_UP   30
+
+    static double other_avg, pixel_avg, load_avg;
     static int cooldown_counter;
 
+    const double target = 1000000.0 / targetrefresh - DRS_PRESENT_US;
+    const double pixels = (double)video.width * video.height;
+    const double frame = frametime_withoutpresent;
+    const double render = MIN(rendertime, frame);
+    const double load = rendered_drawsegs + rendered_visplanes
+                        + rendered_vissprites + rendered_voxels + 1;
+
+    if (pixel_avg == 0.0)
+    {
+        other_avg = frame - render;
+        pixel_avg = render / pixels;
+        load_avg = load;
+    }
+    else
+    {
+        other_avg += DRS_EMA_ALPHA * (frame - render - other_avg);
+        pixel_avg += DRS_EMA_ALPHA * (render / pixels - pixel_avg);
+        load_avg += DRS_EMA_ALPHA * (load - load_avg);
+    }
+
+    const double load_ratio = CLAMP(load / load_avg, 0.5, 2.0);
+    const double render_predicted = pixel_avg * pixels * load_ratio;
+    const double predicted = other_avg + render_predicted;
+
     if (cooldown_counter > 0)
     {
         --cooldown_counter;
         return;
     }
 
-    // 1.25 milliseconds for SDL render present
-    double target = (1.0 / targetrefresh) - 0.00125;
-    double actual = frametime_withoutpresent / 1000000.0;
+    const int oldheight = video.height;
+    const boolean downscale = (predicted > target * DRS_DOWNSCALE_T);
+    int newheight;
 
-    #define DRS_FRAME_HISTORY 30
-    static double frame_history[DRS_FRAME_HISTORY];
-    static int    frame_index;
-
-    frame_history[frame_index] = actual;
-    frame_index = (frame_index + 1) % DRS_FRAME_HISTORY;
-    double total = 0;
-    for (int i = 0; i < DRS_FRAME_HISTORY; ++i)
+    if (downscale)
+    {
+        newheight = oldheight - DRS_STEP;
+    }
+    else if (predicted < target * DRS_UPSCALE_T
+             && oldheight < current_video_height)
     {
-        total += frame_history[i];
+        newheight = oldheight + DRS_MAX_UPSCALE;
+    }
+    else
+    {
+        return;
     }
-    const double avg_frame_time = total / DRS_FRAME_HISTORY;
-    const double performance_ratio = avg_frame_time / target;
 
-    static boolean needs_upscale;
+    // Pixel count goes with the square of the height, as the width follows
+    // the aspect ratio.
 
-    #define DRS_STEP         (SCREENHEIGHT / 2)
-    #define DRS_DOWNSCALE_T1 1.08
-    #define DRS_DOWNSCALE_T2 1.2   // 20% over target -> 2x step
-    #define DRS_DOWNSCALE_T3 1.5   // 50% over target -> 3x step
-    #define DRS_UPSCALE_T1   0.6
-    #define DRS_UPSCALE_T2   0.4
+    const double budget = target * DRS_HEADROOM - other_avg;
 
-    int oldheight = video.height;
-    int newheight = 0;
+    // Without a budget, the frame is over target even without rendering and
+    // the resolution can't help much: step down once or hold.
+
+    if (budget <= 0.0 && !downscale)
+    {
+        return;
+    }
 
-    if (performance_ratio > DRS_DOWNSCALE_T1)
+    if (budget > 0.0 && render_predicted > 0.0)
     {
-        int step_multipler = 1;
-        if (performance_ratio > DRS_DOWNSCALE_T3)
+        int height = (int)(oldheight * sqrt(budget / render_predicted));
+
+        if (height < current_video_height)
         {
-            step_multipler = 3;
+            height = height / DRS_STEP * DRS_STEP;
         }
-        else if (performance_ratio > DRS_DOWNSCALE_T2)
+
+        if (downscale)
         {
-            step_multipler = 2;
+            newheight = MIN(height, oldheight - DRS_STEP);
         }
-
-        newheight = MAX(DRS_MIN_HEIGHT, oldheight - DRS_STEP * step_multipler);
-    }
-    else if (performance_ratio < DRS_UPSCALE_T1 && needs_upscale)
-    {
-        int step_multiplier = 1;
-        if (performance_ratio < DRS_UPSCALE_T2)
+        else
         {
-            step_multiplier = 2;
+            newheight = MAX(oldheight, MIN(height, newheight));
         }
-
-        newheight =
-            MIN(current_video_height, oldheight + DRS_STEP * step_multiplier);
-    }
-    else
-    {
-        return;
     }
 
+    newheight = CLAMP(newheight, DRS_MIN_HEIGHT, current_video_height);
+
     if (newheight == oldheight)
     {
         return;
     }
 
-    needs_upscale = newheight < current_video_height;
-
-    cooldown_counter = DRS_COOLDOWN_FRAMES;
+    cooldown_counter =
+        newheight < oldheight ? DRS_COOLDOWN_DOWN : DRS_COOLDOWN_UP;
 
     if (newheight < oldheight)
     {
@@ -756,6 +794,10 @@ void I_DynamicResolution(void)
         VX_IncreaseMaxDist();
     }
 
+    I_Printf(VB_DEBUG,
+             "I_DynamicResolution: %d -> %d (predicted %.0f us, target %.0f us)",
+             oldheight, newheight, predicted, target);
+
     ResetResolution(newheight, false);
     ResetLogicalSize();
 }
@@ -781,6 +823,8 @@ void I_FinishUpdate(void)
 
     UpdateGrab();
 
+    const uint64_t last_frametime_start = frametime_start;
+
     // [FG] [AM] Real FPS counter
     if (frametime_start)
     {
@@ -810,8 +854,12 @@ void I_FinishUpdate(void)
         frametime_withoutpresent = I_GetTimeUS() - frametime_start;
     }
 
+    const uint64_t present_start = I_GetTimeUS();
+
     SDL_RenderPresent(renderer);
 
+    presenttime = I_GetTimeUS() - present_start;
+
     I_RestoreDiskBackground();
 
     if (window_resize)
@@ -851,6 +899,12 @@ void I_FinishUpdate(void)
         frametime_start = I_GetTimeUS();
     }
 
+    if (last_frametime_start)
+    {
+        frametimes[frametime_index] = frametime_start - last_frametime_start;
+        frametime_index = (frametime_index + 1) % FRAMETIME_HISTORY;
+    }
+
     if (setrefreshneeded)
     {
         setrefreshneeded = false;
@@ -1259,10 +1313,16 @@ static void ResetResolution(int height, boolean reset_pitch)
 
     video.deltaw = (video.unscaledw - NONWIDEWIDTH) / 2;
 
-    Z_FreeTag(PU_VALLOC);
+    // Visplanes are allocated for the full pitch, so only a pitch change
+    // requires freeing them. Dynamic resolution keeps the pitch.
+
+    if (reset_pitch)
+    {
+        Z_FreeTag(PU_VALLOC);
+        R_InitVisplanesRes();
+    }
 
     V_Init();
-    R_InitVisplanesRes();
     R_SetFuzzColumnMode();
     setsizeneeded = true; // run R_ExecuteSetViewSize
 
@@ -1346,10 +1406,9 @@ static void CreateUpscaledTexture(boolean force)
     h_upscale_old = h_upscale;
     w_upscale_old = w_upscale;
 
-    DestroyUpscaledTexture();
-
     if (w_upscale == 1)
     {
+        DestroyUpscaledTexture();
         SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_LINEAR);
         return;
     }
@@ -1358,14 +1417,31 @@ static void CreateUpscaledTexture(boolean force)
         SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
     }
 
+    upscaled_rect.w = w_upscale * screen_width;
+    upscaled_rect.h = h_upscale * screen_height;
+
+    // Keep the current texture if it is large enough and only render into
+    // a part of it. This avoids recreating it on dynamic resolution changes.
+
+    if (texture_upscaled && upscaled_rect.w <= upscaled_width
+        && upscaled_rect.h <= upscaled_height)
+    {
+        return;
+    }
+
+    DestroyUpscaledTexture();
+
     // Set the scaling quality for rendering the upscaled texture
     // to "linear", which looks much softer and smoother than "nearest"
     // but does a better job at downscaling from the upscaled texture to
     // screen.
 
+    upscaled_width = upscaled_rect.w;
+    upscaled_height = upscaled_rect.h;
+
     texture_upscaled = SDL_CreateTexture(
         renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
-        w_upscale * screen_width, h_upscale * screen_height);
+        upscaled_width, upscaled_height);
 
     SDL_SetTextureScaleMode(texture_upscaled, SDL_SCALEMODE_LINEAR);
 }
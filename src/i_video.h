@@ -73,6 +73,10 @@ extern boolean drs_skip_frame;
 extern boolean dynamic_resolution;
 extern boolean uncapped;
 extern int fps;
+
+#define FRAMETIME_HISTORY 64
+extern int frametimes[FRAMETIME_HISTORY], frametime_index; // [us]
+extern int presenttime;
 extern int custom_fov;    // Custom FOV set by the player.
 extern boolean resetneeded;
 extern boolean setrefreshneeded;
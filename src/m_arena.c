@@ -60,7 +60,13 @@ void *M_ArenaAlloc(arena_t *arena, size_t count, size_t size, size_t align)
     if (available < 0 || count > available / size)
     {
         ptrdiff_t buffer_size = arena->end - arena->buffer;
-        if (buffer_size * 2 > arena->reserve)
+        ptrdiff_t used = arena->beg - arena->buffer + padding;
+        ptrdiff_t new_size = buffer_size * 2;
+        while (new_size - used < (ptrdiff_t)(count * size))
+        {
+            new_size *= 2;
+        }
+        if (new_size > arena->reserve)
         {
             I_Error("Out of memory");
         }
@@ -70,13 +76,13 @@ void *M_ArenaAlloc(arena_t *arena, size_t count, size_t size, size_t align)
         {
             I_Error("Failed to decommit region.");
         }
-        if (!I_CommitRegion(arena->buffer, buffer_size * 2))
+        if (!I_CommitRegion(arena->buffer, new_size))
         {
             I_Error("Failed to commit region.");
         }
         memcpy(arena->buffer, buffer, buffer_size);
         free(buffer);
-        arena->end = arena->buffer + buffer_size * 2;
+        arena->end = arena->buffer + new_size;
     }
 
     void *p = arena->beg + padding;
@@ -84,6 +90,25 @@ void *M_ArenaAlloc(arena_t *arena, size_t count, size_t size, size_t align)
     return p;
 }
 
+void *M_ArenaRealloc(arena_t *arena, void *ptr, size_t oldcount,
+                     size_t newcount, size_t size, size_t align)
+{
+    // Grow in place if this is the last allocation.
+    if (ptr && (char *)ptr + oldcount * size == arena->beg
+        && newcount <= (arena->end - (char *)ptr) / size)
+    {
+        arena->beg = (char *)ptr + newcount * size;
+        return ptr;
+    }
+
+    void *p = M_ArenaAlloc(arena, newcount, size, align);
+    if (ptr)
+    {
+        memcpy(p, ptr, (oldcount < newcount ? oldcount : newcount) * size);
+    }
+    return p;
+}
+
 void M_FreeBlock(arena_t *arena, void *ptr, size_t size, size_t align)
 {
     block_t *block;
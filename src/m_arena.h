@@ -25,6 +25,12 @@ typedef struct arena_s arena_t;
 
 void *M_ArenaAlloc(arena_t *arena, size_t count, size_t size, size_t align);
 
+#define arena_realloc(a, p, oldcount, newcount, t)                          \
+    (t *)M_ArenaRealloc(a, p, oldcount, newcount, sizeof(t), alignof(t))
+
+void *M_ArenaRealloc(arena_t *arena, void *ptr, size_t oldcount,
+                     size_t newcount, size_t size, size_t align);
+
 #define arena_free(a, p, t) M_FreeBlock(a, p, sizeof(t), alignof(t))
 
 void M_FreeBlock(arena_t *arena, void *ptr, size_t size, size_t align);
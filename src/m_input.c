@@ -729,6 +729,8 @@ void M_BindInputVariables(void)
     BIND_INPUT(input_demo_quit, "Finish recording demo");
     BIND_INPUT(input_demo_join, "Continue recording current demo");
     BIND_INPUT(input_demo_fforward, "Fast-forward demo");
+    BIND_INPUT(input_demo_seek_forward, "Seek demo forward");
+    BIND_INPUT(input_demo_seek_back, "Seek demo backward");
     BIND_INPUT(input_speed_up, "Increase game speed");
     BIND_INPUT(input_speed_down, "Decrease game speed");
     BIND_INPUT(input_speed_default, "Reset game speed");
@@ -94,6 +94,8 @@ enum
     input_demo_quit,
     input_demo_fforward,
     input_demo_join,
+    input_demo_seek_forward,
+    input_demo_seek_back,
     input_speed_up,
     input_speed_down,
     input_speed_default,
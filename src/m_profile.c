@@ -0,0 +1,233 @@
+//
+// Copyright(C) 2025 Roman Fomin
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+#include "m_profile.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#include "doomtype.h"
+#include "i_printf.h"
+#include "m_argv.h"
+#include "m_array.h"
+#include "m_io.h"
+#include "z_zone.h"
+
+#define TRACE_FILE "startup_trace.json"
+#define MAX_DEPTH 8
+
+typedef struct
+{
+    const char *name;
+    int depth;
+    uint64_t start;   // [us]
+    uint64_t wall;    // [us]
+    uint64_t child;   // [us] wall time of nested phases
+    uint64_t cpu;     // [us]
+    size_t bytes;     // allocated with Z_Malloc
+    size_t allocs;
+} phase_t;
+
+static boolean profile;
+static phase_t *phases;
+static int stack[MAX_DEPTH];
+static int depth;
+
+// I_GetTimeUS() is not usable before I_InitTimer().
+static uint64_t WallTime(void)
+{
+    static uint64_t base;
+    const uint64_t counter = SDL_GetPerformanceCounter();
+
+    if (!base)
+    {
+        base = counter;
+    }
+
+    return (counter - base) * 1000000ull / SDL_GetPerformanceFrequency();
+}
+
+static uint64_t CPUTime(void)
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel,
+                         &user))
+    {
+        return 0;
+    }
+
+    ULARGE_INTEGER k = {.LowPart = kernel.dwLowDateTime,
+                        .HighPart = kernel.dwHighDateTime};
+    ULARGE_INTEGER u = {.LowPart = user.dwLowDateTime,
+                        .HighPart = user.dwHighDateTime};
+
+    return (k.QuadPart + u.QuadPart) / 10; // 100 ns units
+#else
+    return (uint64_t)clock() * 1000000ull / CLOCKS_PER_SEC;
+#endif
+}
+
+void M_InitProfile(void)
+{
+    //!
+    // @category obscure
+    //
+    // Print the time and memory spent in each startup phase and write them
+    // to startup_trace.json in Chrome trace event format.
+    //
+
+    profile = M_ParmExists("-profilestartup");
+
+    if (profile)
+    {
+        WallTime();
+    }
+}
+
+void M_BeginProfile(const char *name)
+{
+    if (!profile)
+    {
+        return;
+    }
+
+    if (depth == MAX_DEPTH)
+    {
+        I_Printf(VB_WARNING, "M_BeginProfile: %s nested too deep", name);
+        return;
+    }
+
+    phase_t phase = {.name = name,
+                     .depth = depth,
+                     .start = WallTime(),
+                     .cpu = CPUTime(),
+                     .bytes = zone_bytes,
+                     .allocs = zone_allocs};
+
+    stack[depth++] = array_size(phases);
+    array_push(phases, phase);
+}
+
+void M_EndProfile(void)
+{
+    if (!profile || !depth)
+    {
+        return;
+    }
+
+    phase_t *phase = &phases[stack[--depth]];
+
+    phase->wall = WallTime() - phase->start;
+    phase->cpu = CPUTime() - phase->cpu;
+    phase->bytes = zone_bytes - phase->bytes;
+    phase->allocs = zone_allocs - phase->allocs;
+
+    if (depth)
+    {
+        phases[stack[depth - 1]].child += phase->wall;
+    }
+}
+
+static void WriteTrace(void)
+{
+    FILE *file = M_fopen(TRACE_FILE, "w");
+
+    if (!file)
+    {
+        I_Printf(VB_ERROR, "M_FinishProfile: Unable to open %s for writing!",
+                 TRACE_FILE);
+        return;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (int i = 0; i < array_size(phases); ++i)
+    {
+        const phase_t *phase = &phases[i];
+
+        fprintf(file,
+                "{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\","
+                "\"pid\":1,\"tid\":1,\"ts\":%llu,\"dur\":%llu,"
+                "\"args\":{\"cpu_us\":%llu,\"bytes\":%llu,\"allocs\":%llu}}%s\n",
+                phase->name, (unsigned long long)phase->start,
+                (unsigned long long)phase->wall,
+                (unsigned long long)phase->cpu,
+                (unsigned long long)phase->bytes,
+                (unsigned long long)phase->allocs,
+                i < array_size(phases) - 1 ? "," : "");
+    }
+
+    fprintf(file, "]}\n");
+    fclose(file);
+
+    I_Printf(VB_ALWAYS, "M_FinishProfile: Trace written to %s", TRACE_FILE);
+}
+
+static int CompareWall(const void *a, const void *b)
+{
+    const phase_t *pa = a, *pb = b;
+
+    if (pa->wall != pb->wall)
+    {
+        return pa->wall < pb->wall ? 1 : -1;
+    }
+    return pa->start < pb->start ? -1 : pa->start > pb->start;
+}
+
+void M_FinishProfile(void)
+{
+    if (!profile)
+    {
+        return;
+    }
+
+    while (depth)
+    {
+        M_EndProfile();
+    }
+
+    WriteTrace();
+
+    // The trace keeps the call order, the table is sorted.
+    qsort(phases, array_size(phases), sizeof(*phases), CompareWall);
+
+    I_Printf(VB_ALWAYS, "%-32s %9s %9s %9s %10s %8s", "Startup phase",
+             "wall ms", "self ms", "cpu ms", "KiB", "allocs");
+
+    for (int i = 0; i < array_size(phases); ++i)
+    {
+        const phase_t *phase = &phases[i];
+
+        I_Printf(VB_ALWAYS, "%*s%-*s %9.1f %9.1f %9.1f %10lu %8lu",
+                 phase->depth * 2, "", 32 - phase->depth * 2, phase->name,
+                 phase->wall / 1000.0, (phase->wall - phase->child) / 1000.0,
+                 phase->cpu / 1000.0, (unsigned long)(phase->bytes / 1024),
+                 (unsigned long)phase->allocs);
+    }
+
+    I_Printf(VB_ALWAYS, "Startup took %.1f ms", WallTime() / 1000.0);
+
+    array_free(phases);
+    profile = false;
+}
@@ -0,0 +1,28 @@
+//
+// Copyright(C) 2025 Roman Fomin
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Startup phase profiler (-profilestartup)
+
+#ifndef M_PROFILE_H
+#define M_PROFILE_H
+
+void M_InitProfile(void);
+
+// Phases may nest. The name must be a string literal.
+void M_BeginProfile(const char *name);
+void M_EndProfile(void);
+
+// Print the phases sorted by wall time and write them as Chrome trace events.
+void M_FinishProfile(void);
+
+#endif
@@ -0,0 +1,254 @@
+//
+// Copyright(C) 2025 Roman Fomin
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+#include "m_tasks.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "doomtype.h"
+#include "i_printf.h"
+#include "m_array.h"
+
+#define MAX_WORKERS 8
+
+struct task_s
+{
+    const char *name;
+    taskfunc_t func;
+    void *data;
+    task_t **dependents;
+    int pending; // unfinished dependencies
+    boolean done;
+    uint64_t time; // [ns]
+};
+
+static SDL_Thread *workers[MAX_WORKERS];
+static int num_workers;
+static boolean quit;
+
+static SDL_Mutex *task_mutex;
+static SDL_Condition *ready_cond;
+static SDL_Condition *done_cond;
+
+static task_t **tasks;
+static task_t **ready;
+
+static uint64_t wait_time; // [ns] main thread blocked in M_WaitTask()
+
+static void RunTask(task_t *task)
+{
+    const uint64_t start = SDL_GetTicksNS();
+    task->func(task->data);
+    task->time = SDL_GetTicksNS() - start;
+}
+
+// Called with the mutex locked.
+static void FinishTask(task_t *task)
+{
+    task_t **dependent;
+    array_foreach(dependent, task->dependents)
+    {
+        if (--(*dependent)->pending == 0)
+        {
+            array_push(ready, *dependent);
+            SDL_SignalCondition(ready_cond);
+        }
+    }
+
+    task->done = true;
+    SDL_BroadcastCondition(done_cond);
+}
+
+static int WorkerThread(void *unused)
+{
+    SDL_LockMutex(task_mutex);
+
+    while (true)
+    {
+        while (array_size(ready) == 0 && !quit)
+        {
+            SDL_WaitCondition(ready_cond, task_mutex);
+        }
+
+        if (array_size(ready) == 0)
+        {
+            break;
+        }
+
+        task_t *task = ready[0];
+        array_delete(ready, 0);
+
+        SDL_UnlockMutex(task_mutex);
+        RunTask(task);
+        SDL_LockMutex(task_mutex);
+
+        FinishTask(task);
+    }
+
+    SDL_UnlockMutex(task_mutex);
+
+    return 0;
+}
+
+static void StartWorkers(void)
+{
+    if (!task_mutex)
+    {
+        task_mutex = SDL_CreateMutex();
+        ready_cond = SDL_CreateCondition();
+        done_cond = SDL_CreateCondition();
+
+        if (!task_mutex || !ready_cond || !done_cond)
+        {
+            return;
+        }
+    }
+
+    // The main thread keeps initializing the rest of the game.
+    int count = SDL_GetNumLogicalCPUCores() - 1;
+    count = CLAMP(count, 1, MAX_WORKERS);
+
+    quit = false;
+
+    for (int i = 0; i < count; ++i)
+    {
+        workers[num_workers] = SDL_CreateThread(WorkerThread, "init worker",
+                                                NULL);
+        if (workers[num_workers])
+        {
+            ++num_workers;
+        }
+    }
+}
+
+task_t *M_AddTask(const char *name, taskfunc_t func, void *data,
+                  task_t **deps, int numdeps)
+{
+    task_t *task = calloc(1, sizeof(*task));
+    task->name = name;
+    task->func = func;
+    task->data = data;
+
+    array_push(tasks, task);
+
+    if (!num_workers)
+    {
+        StartWorkers();
+    }
+
+    if (!num_workers)
+    {
+        // Dependencies have already run as well.
+        RunTask(task);
+        task->done = true;
+        return task;
+    }
+
+    SDL_LockMutex(task_mutex);
+
+    for (int i = 0; i < numdeps; ++i)
+    {
+        if (deps[i] && !deps[i]->done)
+        {
+            ++task->pending;
+            array_push(deps[i]->dependents, task);
+        }
+    }
+
+    if (task->pending == 0)
+    {
+        array_push(ready, task);
+        SDL_SignalCondition(ready_cond);
+    }
+
+    SDL_UnlockMutex(task_mutex);
+
+    return task;
+}
+
+void M_WaitTask(task_t *task)
+{
+    if (!num_workers || !task)
+    {
+        return;
+    }
+
+    const uint64_t start = SDL_GetTicksNS();
+
+    SDL_LockMutex(task_mutex);
+    while (!task->done)
+    {
+        SDL_WaitCondition(done_cond, task_mutex);
+    }
+    SDL_UnlockMutex(task_mutex);
+
+    wait_time += SDL_GetTicksNS() - start;
+}
+
+void M_WaitTasks(void)
+{
+    if (!array_size(tasks))
+    {
+        return;
+    }
+
+    task_t **task;
+    array_foreach(task, tasks)
+    {
+        M_WaitTask(*task);
+    }
+
+    if (num_workers)
+    {
+        SDL_LockMutex(task_mutex);
+        quit = true;
+        SDL_BroadcastCondition(ready_cond);
+        SDL_UnlockMutex(task_mutex);
+
+        for (int i = 0; i < num_workers; ++i)
+        {
+            SDL_WaitThread(workers[i], NULL);
+        }
+    }
+
+    // Time the main thread did not spend on the tasks.
+    uint64_t work_time = 0;
+    array_foreach(task, tasks)
+    {
+        work_time += (*task)->time;
+        I_Printf(VB_DEBUG, "M_WaitTasks: %s took %.1f ms", (*task)->name,
+                 (*task)->time / 1000000.0);
+    }
+
+    if (num_workers)
+    {
+        const int64_t saved = (int64_t)(work_time - wait_time);
+        I_Printf(VB_DEBUG,
+                 "M_WaitTasks: %d tasks on %d threads, %.1f ms saved",
+                 array_size(tasks), num_workers, saved / 1000000.0);
+    }
+
+    array_foreach(task, tasks)
+    {
+        array_free((*task)->dependents);
+        free(*task);
+    }
+    array_free(tasks);
+    array_free(ready);
+
+    num_workers = 0;
+    wait_time = 0;
+}
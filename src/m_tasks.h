@@ -0,0 +1,36 @@
+//
+// Copyright(C) 2025 Roman Fomin
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Thread pool for independent startup work
+
+#ifndef M_TASKS_H
+#define M_TASKS_H
+
+typedef struct task_s task_t;
+
+typedef void (*taskfunc_t)(void *data);
+
+// Run func(data) on a worker thread once all of deps have finished. Tasks run
+// concurrently with the main thread, so they must not use the zone allocator
+// or the WAD cache and must not print: the caller loads the lumps and the
+// results are used only after M_WaitTask(). Without threads the task runs
+// right away.
+task_t *M_AddTask(const char *name, taskfunc_t func, void *data,
+                  task_t **deps, int numdeps);
+
+void M_WaitTask(task_t *task);
+
+// Wait for all tasks and stop the workers.
+void M_WaitTasks(void);
+
+#endif
@@ -15,6 +15,7 @@
 //    Reading of MIDI files.
 //
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -85,6 +86,13 @@ struct midi_file_s
 
     // Number of EMIDI events, without track exclusion.
     unsigned int num_emidi_events;
+
+    // Number of EMIDI loop events local to a track.
+    unsigned int num_track_loops;
+
+    // Events of all tracks merged in playing order:
+    midi_stream_event_t *stream;
+    unsigned int num_stream_events;
 };
 
 // Check the header of a chunk:
@@ -464,11 +472,15 @@ static void CheckUndefinedEvent(midi_file_t *file, const midi_event_t *event)
                 file->num_rpg_events++;
                 break;
 
+            case EMIDI_CONTROLLER_LOOP_BEGIN:
+            case EMIDI_CONTROLLER_LOOP_END:
+                file->num_track_loops++;
+                file->num_emidi_events++;
+                break;
+
             case EMIDI_CONTROLLER_TRACK_DESIGNATION:
             case EMIDI_CONTROLLER_PROGRAM_CHANGE:
             case EMIDI_CONTROLLER_VOLUME:
-            case EMIDI_CONTROLLER_LOOP_BEGIN:
-            case EMIDI_CONTROLLER_LOOP_END:
             case EMIDI_CONTROLLER_GLOBAL_LOOP_BEGIN:
             case EMIDI_CONTROLLER_GLOBAL_LOOP_END:
                 file->num_emidi_events++;
@@ -587,6 +599,75 @@ static boolean ReadAllTracks(midi_file_t *file, MEMFILE *stream)
     return true;
 }
 
+// Merge the events of all tracks into one array with absolute times. Events
+// at the same time are taken from the lowest track first, which is the order
+// in which the players used to merge the track iterators.
+
+static boolean BuildEventStream(midi_file_t *file)
+{
+    unsigned int *position, *time;
+    unsigned int i, total = 0;
+
+    for (i = 0; i < file->num_tracks; ++i)
+    {
+        total += file->tracks[i].num_events;
+    }
+
+    file->stream = malloc(total * sizeof(*file->stream));
+    position = calloc(file->num_tracks, sizeof(*position));
+    time = calloc(file->num_tracks, sizeof(*time));
+
+    if (file->stream == NULL || position == NULL || time == NULL)
+    {
+        free(position);
+        free(time);
+        return false;
+    }
+
+    for (i = 0; i < file->num_tracks; ++i)
+    {
+        if (file->tracks[i].num_events)
+        {
+            time[i] = file->tracks[i].events[0].delta_time;
+        }
+    }
+
+    for (file->num_stream_events = 0; file->num_stream_events < total;
+         ++file->num_stream_events)
+    {
+        midi_stream_event_t *out = &file->stream[file->num_stream_events];
+        unsigned int min_time = UINT_MAX;
+        unsigned int track = 0;
+
+        for (i = 0; i < file->num_tracks; ++i)
+        {
+            if (position[i] < file->tracks[i].num_events && time[i] < min_time)
+            {
+                min_time = time[i];
+                track = i;
+            }
+        }
+
+        const midi_track_t *t = &file->tracks[track];
+        const unsigned int pos = position[track]++;
+
+        out->time = min_time;
+        out->track = track;
+        out->event = &t->events[pos];
+        out->next_delta = 0;
+
+        if (pos + 1 < t->num_events)
+        {
+            out->next_delta = t->events[pos + 1].delta_time;
+            time[track] += out->next_delta;
+        }
+    }
+
+    free(position);
+    free(time);
+    return true;
+}
+
 // Read and check the header chunk.
 
 static boolean ReadFileHeader(midi_file_t *file, MEMFILE *stream)
@@ -638,6 +719,7 @@ void MIDI_FreeFile(midi_file_t *file)
         free(file->tracks);
     }
 
+    free(file->stream);
     free(file);
 }
 
@@ -657,6 +739,9 @@ midi_file_t *MIDI_LoadFile(void *buf, size_t buflen)
     file->num_tracks = 0;
     file->num_rpg_events = 0;
     file->num_emidi_events = 0;
+    file->num_track_loops = 0;
+    file->stream = NULL;
+    file->num_stream_events = 0;
 
     // Open file
 
@@ -680,7 +765,7 @@ midi_file_t *MIDI_LoadFile(void *buf, size_t buflen)
 
     // Read all tracks:
 
-    if (!ReadAllTracks(file, stream))
+    if (!ReadAllTracks(file, stream) || !BuildEventStream(file))
     {
         mem_fclose(stream);
         MIDI_FreeFile(file);
@@ -790,6 +875,18 @@ boolean MIDI_RPGLoop(const midi_file_t *file)
     return (file->num_rpg_events == 1 && file->num_emidi_events == 0);
 }
 
+const midi_stream_event_t *MIDI_GetEventStream(const midi_file_t *file,
+                                               unsigned int *num_events)
+{
+    *num_events = file->num_stream_events;
+    return file->stream;
+}
+
+boolean MIDI_HasTrackLoops(const midi_file_t *file)
+{
+    return file->num_track_loops > 0;
+}
+
 static boolean RolandChecksum(const byte *data)
 {
     const byte checksum =
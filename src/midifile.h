@@ -206,6 +206,20 @@ typedef struct
     } data;
 } midi_event_t;
 
+typedef struct
+{
+    // Time since the start of the song, in ticks.
+    unsigned int time;
+
+    // Track the event belongs to.
+    unsigned int track;
+
+    // Time until the next event of the same track, 0 for the last one.
+    unsigned int next_delta;
+
+    midi_event_t *event;
+} midi_stream_event_t;
+
 // Load a MIDI file.
 
 midi_file_t *MIDI_LoadFile(void *buf, size_t buflen);
@@ -254,4 +268,14 @@ void MIDI_RestartAtLoopPoint(midi_track_iter_t *iter);
 
 boolean MIDI_RPGLoop(const midi_file_t *file);
 
+// Get the events of all tracks merged into one array sorted by time.
+
+const midi_stream_event_t *MIDI_GetEventStream(const midi_file_t *file,
+                                               unsigned int *num_events);
+
+// Check if this MIDI file has EMIDI loops local to a track. Such songs can't
+// be played from the merged event stream.
+
+boolean MIDI_HasTrackLoops(const midi_file_t *file);
+
 #endif /* #ifndef MIDIFILE_H */
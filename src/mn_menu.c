@@ -2689,6 +2689,23 @@ boolean M_ShortcutResponder(const event_t *ev)
         G_LoadAutoKeyframe();
     }
 
+    if (demoplayback && !D_CheckNetConnect())
+    {
+        #define DEMO_SEEK_TICS (10 * TICRATE)
+
+        if (M_InputActivated(input_demo_seek_forward))
+        {
+            G_DemoSeek(playback_tic + DEMO_SEEK_TICS);
+            return true;
+        }
+
+        if (M_InputActivated(input_demo_seek_back))
+        {
+            G_DemoSeek(playback_tic - DEMO_SEEK_TICS);
+            return true;
+        }
+    }
+
     return false;
 }
 
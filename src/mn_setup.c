@@ -1473,6 +1473,8 @@ static setup_menu_t keys_settings3[] = {
     {"Show Stats/Time", S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_hud_timestats},
     MI_GAP,
     {"Fast-FWD Demo",   S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_demo_fforward},
+    {"Seek Demo Fwd",   S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_demo_seek_forward},
+    {"Seek Demo Back",  S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_demo_seek_back},
     {"Finish Demo",     S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_demo_quit},
     {"Join Demo",       S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_demo_join},
     {"Increase Speed",  S_INPUT, KB_X, M_SPC, {0}, m_scrn, input_speed_up},
@@ -343,6 +343,8 @@ static void NET_CL_SendTics(int start, int end)
     // Build a new packet to send to the server
 
     packet = NET_NewPacket(512);
+    NET_ReservePacket(packet,
+                      8 + (end - start + 1) * (2 + NET_TICDIFF_MAX_SIZE));
     NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA);
 
     // Write the start tic and number of tics.  Send only the low byte
@@ -352,6 +354,14 @@ static void NET_CL_SendTics(int start, int end)
     NET_WriteInt8(packet, start & 0xff);
     NET_WriteInt8(packet, end - start + 1);
 
+    // All tics in the packet have the same latency, the compact protocol
+    // only sends it once.
+
+    if (client_connection.protocol == NET_PROTOCOL_WOOF_TICDELTA_0)
+    {
+        NET_WriteLatency(packet, last_latency, client_connection.protocol);
+    }
+
     // Add the tics.
 
     for (i = start; i <= end; ++i)
@@ -360,11 +370,17 @@ static void NET_CL_SendTics(int start, int end)
 
         sendobj = &send_queue[i % BACKUPTICS];
 
-        NET_WriteInt16(packet, last_latency);
+        if (client_connection.protocol != NET_PROTOCOL_WOOF_TICDELTA_0)
+        {
+            NET_WriteLatency(packet, last_latency, client_connection.protocol);
+        }
 
         NET_WriteTiccmdDiff(packet, &sendobj->cmd, settings.lowres_turn);
     }
 
+    NET_Log("client: sending tics %d-%d (%d bytes)", start, end,
+            (int)packet->len);
+
     // Send the packet
 
     NET_Conn_SendPacket(&client_connection, packet);
@@ -760,7 +776,8 @@ static void NET_CL_ParseGameData(net_packet_t *packet)
 
         index = seq - recvwindow_start + i;
 
-        if (!NET_ReadFullTiccmd(packet, &cmd, settings.lowres_turn))
+        if (!NET_ReadFullTiccmd(packet, &cmd, settings.lowres_turn,
+                                client_connection.protocol))
         {
             NET_Log("client: error: failed to read ticcmd %lu",
                     (unsigned long)i);
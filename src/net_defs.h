@@ -124,6 +124,11 @@ typedef enum
     // number in this enum.
     NET_PROTOCOL_CHOCOLATE_DOOM_0,
 
+    // Same as above, with a compact encoding of the ticcmds in game data
+    // packets: variable length latency, latency sent once per client packet
+    // and unchanged player ticcmds omitted from server packets.
+    NET_PROTOCOL_WOOF_TICDELTA_0,
+
     // Add your own protocol here; be sure to add a name for it to the list
     // in net_common.c too.
 
@@ -23,17 +23,54 @@
 
 static int total_packet_memory = 0;
 
+// Freed packets are kept here and handed out again, buffers included, so
+// that once the buffers have grown to the sizes in use, sending and
+// receiving tics does not allocate memory.
+
+#define PACKET_POOL_SIZE 64
+
+static net_packet_t *packet_pool[PACKET_POOL_SIZE];
+static int num_pooled_packets = 0;
+
+static void ResizePacket(net_packet_t *packet, size_t size)
+{
+    total_packet_memory -= packet->alloced;
+
+    packet->alloced = size;
+    packet->data = Z_Realloc(packet->data, size, PU_STATIC, 0);
+
+    total_packet_memory += packet->alloced;
+}
+
 net_packet_t *NET_NewPacket(int initial_size)
 {
     net_packet_t *packet;
 
-    packet = (net_packet_t *)Z_Malloc(sizeof(net_packet_t), PU_STATIC, 0);
-
     if (initial_size == 0)
     {
         initial_size = 256;
     }
 
+    if (num_pooled_packets > 0)
+    {
+        // The most recently freed packet is the most likely to be large
+        // enough.
+
+        packet = packet_pool[--num_pooled_packets];
+
+        if (packet->alloced < (size_t)initial_size)
+        {
+            ResizePacket(packet, initial_size);
+        }
+
+        packet->len = 0;
+        packet->pos = 0;
+
+        return packet;
+    }
+
+    packet = (net_packet_t *)Z_Malloc(sizeof(net_packet_t), PU_STATIC, 0);
+
     packet->alloced = initial_size;
     packet->data = Z_Malloc(initial_size, PU_STATIC, 0);
     packet->len = 0;
@@ -64,6 +101,12 @@ void NET_FreePacket(net_packet_t *packet)
 {
     // printf("%p: destroyed\n", packet);
 
+    if (num_pooled_packets < PACKET_POOL_SIZE)
+    {
+        packet_pool[num_pooled_packets++] = packet;
+        return;
+    }
+
     total_packet_memory -= sizeof(net_packet_t) + packet->alloced;
     Z_Free(packet->data);
     Z_Free(packet);
@@ -246,20 +289,18 @@ char *NET_ReadSafeString(net_packet_t *packet)
 
 static void NET_IncreasePacket(net_packet_t *packet)
 {
-    byte *newdata;
-
-    total_packet_memory -= packet->alloced;
-
-    packet->alloced *= 2;
-
-    newdata = Z_Malloc(packet->alloced, PU_STATIC, 0);
-
-    memcpy(newdata, packet->data, packet->len);
+    ResizePacket(packet, packet->alloced * 2);
+}
 
-    Z_Free(packet->data);
-    packet->data = newdata;
+// Make room for writing up to size more bytes, so that the writes that
+// follow fill the buffer in place.
 
-    total_packet_memory += packet->alloced;
+void NET_ReservePacket(net_packet_t *packet, size_t size)
+{
+    if (packet->len + size > packet->alloced)
+    {
+        ResizePacket(packet, packet->len + size);
+    }
 }
 
 // Write a single byte to the packet
@@ -1173,6 +1173,7 @@ static void NET_SV_ParseGameData(net_packet_t *packet, net_client_t *client)
     int player;
     int resend_start, resend_end;
     int index;
+    signed int latency;
 
     if (server_state != SERVER_IN_GAME)
     {
@@ -1210,12 +1211,22 @@ static void NET_SV_ParseGameData(net_packet_t *packet, net_client_t *client)
 
     // Sanity checks
 
+    // In the compact protocol, all tics in the packet share the latency.
+
+    if (client->connection.protocol == NET_PROTOCOL_WOOF_TICDELTA_0
+        && !NET_ReadLatency(packet, &latency, client->connection.protocol))
+    {
+        NET_Log("server: error: failed to read latency");
+        return;
+    }
+
     for (i = 0; i < num_tics; ++i)
     {
         net_ticdiff_t diff;
-        signed int latency;
 
-        if (!NET_ReadSInt16(packet, &latency)
+        if ((client->connection.protocol != NET_PROTOCOL_WOOF_TICDELTA_0
+             && !NET_ReadLatency(packet, &latency,
+                                 client->connection.protocol))
             || !NET_ReadTiccmdDiff(packet, &diff, sv_settings.lowres_turn))
         {
             return;
@@ -1343,6 +1354,7 @@ static void NET_SV_SendTics(net_client_t *client, unsigned int start,
     unsigned int i;
 
     packet = NET_NewPacket(500);
+    NET_ReservePacket(packet, 4 + (end - start + 1) * NET_FULLTICCMD_MAX_SIZE);
 
     NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA);
 
@@ -1366,9 +1378,13 @@ static void NET_SV_SendTics(net_client_t *client, unsigned int start,
 
         // Add command
 
-        NET_WriteFullTiccmd(packet, cmd, sv_settings.lowres_turn);
+        NET_WriteFullTiccmd(packet, cmd, sv_settings.lowres_turn,
+                            client->connection.protocol);
     }
 
+    NET_Log("server: sending tics %u-%u to %s (%d bytes)", start, end,
+            NET_AddrToString(client->addr), (int)packet->len);
+
     // Send packet
 
     NET_Conn_SendPacket(&client->connection, packet);
@@ -30,6 +30,7 @@ static struct
     const char *name;
 } protocol_names[] = {
     {NET_PROTOCOL_CHOCOLATE_DOOM_0, "CHOCOLATE_DOOM_0"},
+    {NET_PROTOCOL_WOOF_TICDELTA_0,  "WOOF_TICDELTA_0"  },
 };
 
 void NET_WriteConnectData(net_packet_t *packet, net_connect_data_t *data)
@@ -382,15 +383,76 @@ void NET_TiccmdPatch(ticcmd_t *src, net_ticdiff_t *diff, ticcmd_t *dest)
 // net_full_ticcmd_t
 //
 
+// Latency is a 16-bit value in the original protocol. The compact protocol
+// sends it zigzag encoded, 7 bits per byte, so that the usual small values
+// take a single byte.
+
+boolean NET_ReadLatency(net_packet_t *packet, signed int *latency,
+                        net_protocol_t protocol)
+{
+    unsigned int val, b;
+    int shift;
+
+    if (protocol != NET_PROTOCOL_WOOF_TICDELTA_0)
+    {
+        return NET_ReadSInt16(packet, latency);
+    }
+
+    val = 0;
+
+    for (shift = 0; shift < 21; shift += 7)
+    {
+        if (!NET_ReadInt8(packet, &b))
+        {
+            return false;
+        }
+
+        val |= (b & 0x7f) << shift;
+
+        if (!(b & 0x80))
+        {
+            *latency = (val & 1) ? -(signed int)(val >> 1) - 1
+                                 : (signed int)(val >> 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NET_WriteLatency(net_packet_t *packet, signed int latency,
+                      net_protocol_t protocol)
+{
+    unsigned int val;
+
+    if (protocol != NET_PROTOCOL_WOOF_TICDELTA_0)
+    {
+        NET_WriteInt16(packet, latency);
+        return;
+    }
+
+    latency = CLAMP(latency, -32768, 32767);
+    val = latency < 0 ? ((unsigned int)(-(latency + 1)) << 1) | 1
+                      : (unsigned int)latency << 1;
+
+    while (val >= 0x80)
+    {
+        NET_WriteInt8(packet, (val & 0x7f) | 0x80);
+        val >>= 7;
+    }
+
+    NET_WriteInt8(packet, val);
+}
+
 boolean NET_ReadFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd,
-                           boolean lowres_turn)
+                           boolean lowres_turn, net_protocol_t protocol)
 {
-    unsigned int bitfield;
+    unsigned int bitfield, changed;
     int i;
 
     // Latency
 
-    if (!NET_ReadSInt16(packet, &cmd->latency))
+    if (!NET_ReadLatency(packet, &cmd->latency, protocol))
     {
         return false;
     }
@@ -407,16 +469,33 @@ boolean NET_ReadFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd,
         cmd->playeringame[i] = (bitfield & (1 << i)) != 0;
     }
 
+    // The compact protocol only sends the players whose ticcmds changed
+    // since their previous tic.
+
+    changed = bitfield;
+
+    if (protocol == NET_PROTOCOL_WOOF_TICDELTA_0
+        && !NET_ReadInt8(packet, &changed))
+    {
+        return false;
+    }
+
     // Read cmds
 
     for (i = 0; i < NET_MAXPLAYERS; ++i)
     {
-        if (cmd->playeringame[i])
+        if (!cmd->playeringame[i])
         {
-            if (!NET_ReadTiccmdDiff(packet, &cmd->cmds[i], lowres_turn))
-            {
-                return false;
-            }
+            continue;
+        }
+
+        if (!(changed & (1 << i)))
+        {
+            cmd->cmds[i].diff = 0;
+        }
+        else if (!NET_ReadTiccmdDiff(packet, &cmd->cmds[i], lowres_turn))
+        {
+            return false;
         }
     }
 
@@ -424,35 +503,50 @@ boolean NET_ReadFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd,
 }
 
 void NET_WriteFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd,
-                         boolean lowres_turn)
+                         boolean lowres_turn, net_protocol_t protocol)
 {
-    unsigned int bitfield;
+    unsigned int bitfield, changed;
     int i;
 
     // Write the latency
 
-    NET_WriteInt16(packet, cmd->latency);
+    NET_WriteLatency(packet, cmd->latency, protocol);
 
     // Write "header" byte indicating which players are active
     // in this ticcmd
 
     bitfield = 0;
+    changed = 0;
 
     for (i = 0; i < NET_MAXPLAYERS; ++i)
     {
         if (cmd->playeringame[i])
         {
             bitfield |= 1 << i;
+
+            if (cmd->cmds[i].diff != 0)
+            {
+                changed |= 1 << i;
+            }
         }
     }
 
     NET_WriteInt8(packet, bitfield);
 
+    if (protocol == NET_PROTOCOL_WOOF_TICDELTA_0)
+    {
+        NET_WriteInt8(packet, changed);
+    }
+    else
+    {
+        changed = bitfield;
+    }
+
     // Write player ticcmds
 
     for (i = 0; i < NET_MAXPLAYERS; ++i)
     {
-        if (cmd->playeringame[i])
+        if (changed & (1 << i))
         {
             NET_WriteTiccmdDiff(packet, &cmd->cmds[i], lowres_turn);
         }
@@ -32,6 +32,12 @@ extern void NET_WriteQueryData(net_packet_t *packet,
 extern boolean NET_ReadQueryData(net_packet_t *packet,
                                  net_querydata_t *querydata);
 
+// Upper bounds on the encoded size of ticcmds: header byte, forward, side,
+// turn (16 bits), buttons, consistancy and chatchar for a diff; latency (up
+// to 3 bytes), player bitfields and a diff per player for a full ticcmd.
+#define NET_TICDIFF_MAX_SIZE     8
+#define NET_FULLTICCMD_MAX_SIZE  (5 + NET_MAXPLAYERS * NET_TICDIFF_MAX_SIZE)
+
 extern void NET_WriteTiccmdDiff(net_packet_t *packet, net_ticdiff_t *diff,
                                 boolean lowres_turn);
 extern boolean NET_ReadTiccmdDiff(net_packet_t *packet, net_ticdiff_t *diff,
@@ -40,9 +46,15 @@ extern void NET_TiccmdDiff(ticcmd_t *tic1, ticcmd_t *tic2, net_ticdiff_t *diff);
 extern void NET_TiccmdPatch(ticcmd_t *src, net_ticdiff_t *diff, ticcmd_t *dest);
 
 boolean NET_ReadFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd,
-                           boolean lowres_turn);
+                           boolean lowres_turn, net_protocol_t protocol);
 void NET_WriteFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd,
-                         boolean lowres_turn);
+                         boolean lowres_turn, net_protocol_t protocol);
+
+// Latency of the tics in a game data packet, in the encoding of the protocol.
+boolean NET_ReadLatency(net_packet_t *packet, signed int *latency,
+                        net_protocol_t protocol);
+void NET_WriteLatency(net_packet_t *packet, signed int latency,
+                      net_protocol_t protocol);
 
 boolean NET_ReadSHA1Sum(net_packet_t *packet, sha1_digest_t digest);
 void NET_WriteSHA1Sum(net_packet_t *packet, sha1_digest_t digest);
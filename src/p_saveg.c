@@ -95,48 +95,59 @@ inline static void saveg_writep(const void *p)
 #define saveg_read_enum saveg_read32
 #define saveg_write_enum saveg_write32
 
-// [crispy] enumerate all thinker pointers
-static int P_ThinkerToIndex(thinker_t* thinker)
-{
-    thinker_t* th;
-    int i;
+// killough 2/14/98: count the number of mobj thinkers, and mark each one
+// with its index, using the prev field as a placeholder, since it can be
+// restored later.
 
-    if (!thinker)
-        return 0;
+static void P_NumberMobjThinkers(void)
+{
+    thinker_t *th;
+    size_t size = 0;
 
-    for (th = thinkercap.next, i = 0; th != &thinkercap; th = th->next)
+    for (th = thinkercap.next; th != &thinkercap; th = th->next)
     {
         if (th->function.pm == P_MobjThinker)
         {
-            i++;
-            if (th == thinker)
-                return i;
+            th->prev = (thinker_t *) ++size;
         }
     }
+}
+
+// killough 2/14/98: restore prev pointers
+
+static void P_RestoreThinkerLinks(void)
+{
+    thinker_t *th, *prev = &thinkercap;
+
+    for (th = thinkercap.next; th != &thinkercap; prev = th, th = th->next)
+    {
+        th->prev = prev;
+    }
+}
+
+// killough 2/14/98: translation table from indices to mobj pointers, built
+// by P_UnArchiveThinkers() and freed by P_UnArchiveSpecials()
+
+static mobj_t **mobj_p;
+static size_t mobj_p_size;
+
+// [crispy] enumerate all thinker pointers
+// Only valid between P_NumberMobjThinkers() and P_RestoreThinkerLinks().
+static int P_ThinkerToIndex(thinker_t* thinker)
+{
+    if (!thinker || thinker->function.pm != P_MobjThinker)
+        return 0;
 
-    return 0;
+    return (int) (intptr_t) thinker->prev;
 }
 
 // [crispy] replace indizes with corresponding pointers
 static thinker_t* P_IndexToThinker(int index)
 {
-    thinker_t* th;
-    int i;
-
-    if (!index)
+    if (index <= 0 || (size_t) index >= mobj_p_size)
         return NULL;
 
-    for (th = thinkercap.next, i = 0; th != &thinkercap; th = th->next)
-    {
-        if (th->function.pm == P_MobjThinker)
-        {
-            i++;
-            if (i == index)
-                return th;
-        }
-    }
-
-    return NULL;
+    return &mobj_p[index]->thinker;
 }
 
 //
@@ -2309,19 +2320,12 @@ typedef enum {
 void P_ArchiveThinkers (void)
 {
   thinker_t *th;
-  size_t    size = 0;
 
   // killough 3/26/98: Save boss brain state
   saveg_write32(brain.easy);
   saveg_write32(brain.targeton);
 
-  // killough 2/14/98:
-  // count the number of thinkers, and mark each one with its index, using
-  // the prev field as a placeholder, since it can be restored later.
-
-  for (th = thinkercap.next ; th != &thinkercap ; th=th->next)
-    if (th->function.pm == P_MobjThinker)
-      th->prev = (thinker_t *) ++size;
+  P_NumberMobjThinkers();
 
   // save off the current thinkers
 
@@ -2418,13 +2422,7 @@ void P_ArchiveThinkers (void)
      }
   }
   
-  // killough 2/14/98: restore prev pointers
-  {
-    thinker_t *prev = &thinkercap;
-    for (th = thinkercap.next ; th != &thinkercap ; prev=th, th=th->next)
-      th->prev = prev;
-  }
-  // killough 2/14/98: end changes
+  P_RestoreThinkerLinks();
 }
 
 //
@@ -2450,7 +2448,6 @@ static void P_SetNewTarget(mobj_t **mop, mobj_t *targ)
 void P_UnArchiveThinkers (void)
 {
   thinker_t *th;
-  mobj_t    **mobj_p;    // killough 2/14/98: Translation table
   size_t    size;        // killough 2/14/98: size of or index into table
   size_t    idx;         // haleyjd 11/03/06: separate index var
 
@@ -2501,7 +2498,10 @@ void P_UnArchiveThinkers (void)
       I_Error ("Unknown tclass %i in savegame", *save_p);
 
     // first table entry special: 0 maps to NULL
+    if (mobj_p)
+      Z_Free(mobj_p);
     *(mobj_p = Z_Malloc(size * sizeof *mobj_p, PU_STATIC, 0)) = 0;   // table of pointers
+    mobj_p_size = size;
     save_p = sp;           // restore save pointer
   }
 
@@ -2605,8 +2605,6 @@ void P_UnArchiveThinkers (void)
     }
   }
 
-  Z_Free(mobj_p);    // free translation table
-
   // killough 3/26/98: Spawn icon landings:
   if (gamemode == commercial)
     P_SpawnBrainTargets();
@@ -2652,6 +2650,9 @@ void P_ArchiveSpecials (void)
 {
   thinker_t *th;
 
+  // pushers refer to their source by index
+  P_NumberMobjThinkers();
+
   // save off the current thinkers
   for (th=thinkercap.next; th!=&thinkercap; th=th->next)
     {
@@ -2791,6 +2792,8 @@ void P_ArchiveSpecials (void)
 
   // add a terminating marker
   saveg_write8(tc_endspecials);
+
+  P_RestoreThinkerLinks();
 }
 
 
@@ -2957,6 +2960,10 @@ void P_UnArchiveSpecials (void)
       default:
         I_Error ("Unknown tclass %i in savegame",tclass);
       }
+
+  Z_Free(mobj_p);    // free translation table
+  mobj_p = NULL;
+  mobj_p_size = 0;
 }
 
 // killough 2/16/98: save/restore random number generator state information
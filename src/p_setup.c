@@ -52,6 +52,7 @@
 #include "r_main.h"
 #include "r_state.h"
 #include "r_things.h"
+#include "r_voxel.h"
 #include "s_musinfo.h" // [crispy] S_ParseMusInfo()
 #include "s_sound.h"
 #include "tables.h"
@@ -1753,9 +1754,12 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
   P_SpawnSpecials();
   P_MapEnd();
 
-  // preload graphics
-  if (precache)
-    R_PrecacheLevel();
+  // preload graphics, or queue them if level loading should be fast
+  R_PrecacheLevel();
+  VX_PrecacheLevel();
+
+  // preload sound effects, if not already done at startup
+  S_PrecacheLevel();
 
   // [FG] log level setup
   I_Printf(VB_DEMO, "P_SetupLevel: %.8s (%s), Skill %d, %s%s%s, %s",
@@ -20,6 +20,7 @@
 #include "d_think.h"
 #include "doomdef.h"
 #include "doomstat.h"
+#include "i_timer.h"
 #include "info.h"
 #include "m_arena.h"
 #include "p_map.h"
@@ -328,13 +329,21 @@ void P_SetTarget(mobj_t **mop, mobj_t *targ)
 // external and using P_RemoveThinkerDelayed() implicitly.
 //
 
+// Frame statistics widget: thinkers run and time spent in the last tic.
+int thinkers_run, tictime;
+
 static void P_RunThinkers (void)
 {
+  thinkers_run = 0;
+
   for (currentthinker = thinkercap.next;
        currentthinker != &thinkercap;
        currentthinker = currentthinker->next)
     if (currentthinker->function.pv)
+    {
       currentthinker->function.pv(currentthinker);
+      thinkers_run++;
+    }
 
   // [crispy] support MUSINFO lump (dynamic music changing)
   T_MusInfo();
@@ -394,6 +403,8 @@ void P_Ticker (void)
 		 players[consoleplayer].viewz != 1))
     return;
 
+  const uint64_t start = I_GetTimeUS();
+
   if (frozen_mode)
   {
     P_FrozenTicker();
@@ -414,6 +425,8 @@ void P_Ticker (void)
   P_MapEnd();
   }
 
+  tictime = I_GetTimeUS() - start;
+
   leveltime++;                       // for par times
 }
 
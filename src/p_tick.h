@@ -32,6 +32,8 @@ struct plat_s;
 
 void P_Ticker(void);
 
+extern int thinkers_run, tictime; // [us]
+
 extern thinker_t thinkercap;  // Both the head and tail of the thinker list
 
 void P_InitThinkers(void);
@@ -55,6 +55,7 @@ static const char *params[] = {
 "-shorttics",
 "-tas",
 "-nogui",
+"-profilestartup",
 };
 
 static const char *params_with_args[] = {
@@ -89,6 +90,7 @@ static const char *params_with_args[] = {
 "-record",
 "-recordfrom",
 "-recordfromto",
+"-recoverdemo",
 "-skipsec",
 "-timedemo",
 "-cl",
@@ -58,6 +58,9 @@ unsigned  maxdrawsegs;
 
 void R_ClearDrawSegs(void)
 {
+  if (!maxdrawsegs)
+    maxdrawsegs = 128;
+  drawsegs = arena_alloc(frame_arena, maxdrawsegs, drawseg_t);
   ds_p = drawsegs;
 }
 
@@ -32,13 +32,16 @@
 #include "doomtype.h"
 #include "i_printf.h"
 #include "i_system.h"
+#include "i_timer.h"
 #include "info.h"
 #include "m_argv.h" // M_CheckParm()
 #include "m_array.h"
 #include "m_fixed.h"
 #include "m_io.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "m_swap.h"
+#include "m_tasks.h"
 #include "p_mobj.h"
 #include "p_tick.h"
 #include "r_bmaps.h" // [crispy] R_BrightmapForTexName()
@@ -307,6 +310,21 @@ static void R_GenerateComposite(int texnum)
   Z_ChangeTag(block2, PU_CACHE);
 }
 
+// Per-level statistics: composites generated ahead of time by
+// R_PrecacheLevel() or R_UpdatePrecache(), and those that had to be
+// generated on demand while drawing.
+
+static int composites_precached, composites_ondemand;
+
+static void R_PrecacheComposite(int texnum)
+{
+  if (!texturecomposite[texnum] || !texturecomposite2[texnum])
+  {
+    composites_precached++;
+    R_GenerateComposite(texnum);
+  }
+}
+
 //
 // R_GenerateLookup
 //
@@ -504,7 +522,10 @@ byte *R_GetColumn(int tex, int col)
   ofs  = texturecolumnofs2[tex][col];
 
   if (!texturecomposite2[tex])
+  {
+    composites_ondemand++;
     R_GenerateComposite(tex);
+  }
 
   return texturecomposite2[tex] + ofs;
 }
@@ -521,7 +542,10 @@ byte *R_GetColumnMasked(int tex, int col)
   ofs  = texturecolumnofs[tex][col];
 
   if (!texturecomposite[tex])
+  {
+    composites_ondemand++;
     R_GenerateComposite(tex);
+  }
 
   return texturecomposite[tex] + ofs;
 }
@@ -966,6 +990,108 @@ int tran_filter_pct = 66;       // filter percent
 
 #define TSC 12        /* number of fixed point digits in filter percent */
 
+typedef struct {
+  unsigned char pct;
+  unsigned char playpal[256*3]; // [FG] a palette has 256 colors saved as byte triples
+} tranmap_cache_t;
+
+typedef struct {
+  tranmap_cache_t cache;
+  byte *tranmap;
+  FILE *cachefp;            // write out the cached translucency map
+  boolean disk;             // display flashing disk
+  char *dumpname;
+} tranmap_job_t;
+
+static tranmap_job_t tranmap_job;
+
+static void BuildTranMap(void *data)
+{
+  tranmap_job_t *job = data;
+  const unsigned char *playpal = job->cache.playpal;
+  long pal[3][256], tot[256], pal_w1[3][256];
+  long w1 = ((unsigned long) job->cache.pct<<TSC)/100;
+  long w2 = (1l<<TSC)-w1;
+
+  // First, convert playpal into long int type, and transpose array,
+  // for fast inner-loop calculations. Precompute tot array.
+
+  {
+    register int i = 255;
+    register const unsigned char *p = playpal+255*3;
+    do
+      {
+        register long t,d;
+        pal_w1[0][i] = (pal[0][i] = t = p[0]) * w1;
+        d = t*t;
+        pal_w1[1][i] = (pal[1][i] = t = p[1]) * w1;
+        d += t*t;
+        pal_w1[2][i] = (pal[2][i] = t = p[2]) * w1;
+        d += t*t;
+        p -= 3;
+        tot[i] = d << (TSC-1);
+      }
+    while (--i>=0);
+  }
+
+  // Next, compute all entries using minimum arithmetic.
+
+  {
+    int i,j;
+    byte *tp = job->tranmap;
+    for (i=0;i<256;i++)
+      {
+        long r1 = pal[0][i] * w2;
+        long g1 = pal[1][i] * w2;
+        long b1 = pal[2][i] * w2;
+
+        if (!(~i & 15) && job->disk)
+        {
+          if (i & 32)       // killough 10/98: display flashing disk
+            I_EndRead();
+          else
+            I_BeginRead(DISK_ICON_THRESHOLD);
+        }
+
+        for (j=0;j<256;j++,tp++)
+          {
+            register int color = 255;
+            register long err;
+            long r = pal_w1[0][j] + r1;
+            long g = pal_w1[1][j] + g1;
+            long b = pal_w1[2][j] + b1;
+            long best = LONG_MAX;
+            do
+              if ((err = tot[color] - pal[0][color]*r
+                  - pal[1][color]*g - pal[2][color]*b) < best)
+                best = err, *tp = color;
+            while (--color >= 0);
+          }
+      }
+  }
+
+  if (job->cachefp) // write out the cached translucency map
+    {
+      fseek(job->cachefp, 0, SEEK_SET);
+      fwrite(&job->cache, 1, sizeof job->cache, job->cachefp);
+      fwrite(job->tranmap, 256, 256, job->cachefp);
+      fclose(job->cachefp);
+      job->cachefp = NULL;
+    }
+}
+
+static void DumpTranMap(void *data)
+{
+  tranmap_job_t *job = data;
+
+  M_WriteFile(job->dumpname, job->tranmap, 256 * 256);
+  free(job->dumpname);
+  job->dumpname = NULL;
+}
+
+// At startup the table is composed by a worker thread while the rest of the
+// game initializes. It must not be used before M_WaitTasks().
+
 void R_InitTranMap(int progress)
 {
   int lump = W_CheckNumForName("TRANMAP");
@@ -975,6 +1101,7 @@ void R_InitTranMap(int progress)
   // Forces a (re-)building of the translucency and color translation tables.
   //
   int force_rebuild = M_CheckParm("-tranmap");
+  task_t *task = NULL;
 
   // If a tranlucency filter map lump is present, use it
 
@@ -984,10 +1111,7 @@ void R_InitTranMap(int progress)
     {   // Compose a default transparent filter map based on PLAYPAL.
       unsigned char *playpal = W_CacheLumpName("PLAYPAL", PU_STATIC);
       char *fname = M_StringJoin(D_DoomPrefDir(), DIR_SEPARATOR_S, "tranmap.dat");
-      struct {
-        unsigned char pct;
-        unsigned char playpal[256*3]; // [FG] a palette has 256 colors saved as byte triples
-      } cache;
+      tranmap_cache_t cache;
       FILE *cachefp = M_fopen(fname,"r+b");
 
       if (main_tranmap == NULL) // [FG] prevent memory leak
@@ -1004,84 +1128,29 @@ void R_InitTranMap(int progress)
           fread(main_tranmap, 256, 256, cachefp) != 256 ||  // killough 4/11/98
           force_rebuild)
         {
-          long pal[3][256], tot[256], pal_w1[3][256];
-          long w1 = ((unsigned long) tran_filter_pct<<TSC)/100;
-          long w2 = (1l<<TSC)-w1;
-
-          // First, convert playpal into long int type, and transpose array,
-          // for fast inner-loop calculations. Precompute tot array.
-
-          {
-            register int i = 255;
-            register const unsigned char *p = playpal+255*3;
-            do
-              {
-                register long t,d;
-                pal_w1[0][i] = (pal[0][i] = t = p[0]) * w1;
-                d = t*t;
-                pal_w1[1][i] = (pal[1][i] = t = p[1]) * w1;
-                d += t*t;
-                pal_w1[2][i] = (pal[2][i] = t = p[2]) * w1;
-                d += t*t;
-                p -= 3;
-                tot[i] = d << (TSC-1);
-              }
-            while (--i>=0);
-          }
-
-          // Next, compute all entries using minimum arithmetic.
-
-          {
-            int i,j;
-            byte *tp = main_tranmap;
-            for (i=0;i<256;i++)
-              {
-                long r1 = pal[0][i] * w2;
-                long g1 = pal[1][i] * w2;
-                long b1 = pal[2][i] * w2;
-
-                if (!(i & 31) && progress)
-		  I_PutChar(VB_INFO, '.');
-
-		if (!(~i & 15))
-		{
-		  if (i & 32)       // killough 10/98: display flashing disk
-		    I_EndRead();
-		  else
-		    I_BeginRead(DISK_ICON_THRESHOLD);
-		}
-
-                for (j=0;j<256;j++,tp++)
-                  {
-                    register int color = 255;
-                    register long err;
-                    long r = pal_w1[0][j] + r1;
-                    long g = pal_w1[1][j] + g1;
-                    long b = pal_w1[2][j] + b1;
-                    long best = LONG_MAX;
-                    do
-                      if ((err = tot[color] - pal[0][color]*r
-                          - pal[1][color]*g - pal[2][color]*b) < best)
-                        best = err, *tp = color;
-                    while (--color >= 0);
-                  }
-              }
-            // [FG] finish progress line
-            if (progress)
-              I_PutChar(VB_INFO, '\n');
-          }
-          if (cachefp && !force_rebuild) // write out the cached translucency map
+          tranmap_job.cache.pct = tran_filter_pct;
+          memcpy(tranmap_job.cache.playpal, playpal, sizeof tranmap_job.cache.playpal); // [FG] a palette has 256 colors saved as byte triples
+          tranmap_job.tranmap = main_tranmap;
+          tranmap_job.cachefp = force_rebuild ? NULL : cachefp;
+          if (tranmap_job.cachefp)
+            cachefp = NULL;
+
+          if (progress)
+            {
+              tranmap_job.disk = false;
+              task = M_AddTask("R_InitTranMap", BuildTranMap, &tranmap_job,
+                               NULL, 0);
+            }
+          else
             {
-              cache.pct = tran_filter_pct;
-              memcpy(cache.playpal, playpal, sizeof cache.playpal); // [FG] a palette has 256 colors saved as byte triples
-              fseek(cachefp, 0, SEEK_SET);
-              fwrite(&cache, 1, sizeof cache, cachefp);
-              fwrite(main_tranmap, 256, 256, cachefp);
+              tranmap_job.disk = true;
+              BuildTranMap(&tranmap_job);
             }
         }
-      else
-	if (progress)
-	  I_Printf(VB_INFO, "........");
+
+      // The progress is the same for the cached map, workers don't print.
+      if (progress)
+        I_Printf(VB_INFO, "........");
 
       if (cachefp)              // killough 11/98: fix filehandle leak
 	fclose(cachefp);
@@ -1100,11 +1169,17 @@ void R_InitTranMap(int progress)
   int p = M_CheckParmWithArgs("-dumptranmap", 1);
   if (p > 0)
   {
-      char *path = AddDefaultExtension(myargv[p + 1], ".lmp");
+      tranmap_job.tranmap = main_tranmap;
+      tranmap_job.dumpname = AddDefaultExtension(myargv[p + 1], ".lmp");
 
-      M_WriteFile(path, main_tranmap, 256 * 256);
-
-      free(path);
+      if (task)
+      {
+          M_AddTask("DumpTranMap", DumpTranMap, &tranmap_job, &task, 1);
+      }
+      else
+      {
+          DumpTranMap(&tranmap_job);
+      }
   }
 }
 
@@ -1121,11 +1196,19 @@ void R_InitData(void)
   // which are required by R_InitTextures() to prevent flat lumps from being
   // mistaken as patches and by R_InitFlatBrightmaps() to set brightmaps for
   // flats.
+  M_BeginProfile("R_InitFlats");
   R_InitFlats();
   R_InitFlatBrightmaps();
+  M_EndProfile();
+  M_BeginProfile("R_InitTextures");
   R_InitTextures();
+  M_EndProfile();
+  M_BeginProfile("R_InitSpriteLumps");
   R_InitSpriteLumps();
+  M_EndProfile();
+  M_BeginProfile("R_InitTranMap");
     R_InitTranMap(1);                   // killough 2/21/98, 3/6/98
+  M_EndProfile();
   R_InitColormaps();                    // killough 3/20/98
   R_InitSkyDefs();
 }
@@ -1196,14 +1279,126 @@ int R_TextureNumForName(const char *name)  // const added -- killough
 //
 // Totally rewritten by Lee Killough to use less memory,
 // to avoid using alloca(), and to improve performance.
+//
+// During demo playback, when level loading should not take long, wall
+// texture composites are queued instead and generated incrementally by
+// R_UpdatePrecache(), nearest to the player first.
+
+typedef struct
+{
+  int texnum;
+  int dist;
+} precache_t;
+
+static precache_t *precache_queue;
+static int precache_next;
+
+// Time spent generating queued composites per rendered frame.
+#define PRECACHE_BUDGET_US 1000
+
+static int ComparePrecache(const void *a, const void *b)
+{
+  const precache_t *pa = a, *pb = b;
+
+  if (pa->dist != pb->dist)
+    return pa->dist - pb->dist;
+
+  return pa->texnum - pb->texnum;
+}
+
+static void R_QueueTexture(int *dist, int texnum, int d)
+{
+  if (texnum > 0 && texnum < numtextures && d < dist[texnum])
+    dist[texnum] = d;
+}
+
+static void R_QueuePrecache(void)
+{
+  const mobj_t *mo = players[displayplayer].mo;
+  int *dist = Z_Malloc(numtextures * sizeof(*dist), PU_STATIC, 0);
+  int i;
+
+  for (i = 0; i < numtextures; i++)
+    dist[i] = INT_MAX;
+
+  for (i = 0; i < numlines; i++)
+  {
+    const line_t *line = &lines[i];
+    int d = 0, s;
+
+    if (mo)
+    {
+      const int x = (line->v1->x >> 1) + (line->v2->x >> 1);
+      const int y = (line->v1->y >> 1) + (line->v2->y >> 1);
+      d = abs((x >> FRACBITS) - (mo->x >> FRACBITS))
+        + abs((y >> FRACBITS) - (mo->y >> FRACBITS));
+    }
+
+    for (s = 0; s < 2; s++)
+    {
+      if (line->sidenum[s] != NO_INDEX)
+      {
+        const side_t *side = &sides[line->sidenum[s]];
+        R_QueueTexture(dist, side->toptexture, d);
+        R_QueueTexture(dist, side->midtexture, d);
+        R_QueueTexture(dist, side->bottomtexture, d);
+      }
+    }
+  }
+
+  // Sky textures are always visible.
+  sky_t *sky;
+  array_foreach(sky, levelskies)
+  {
+    R_QueueTexture(dist, sky->background.texture, 0);
+  }
+
+  for (i = 0; i < numtextures; i++)
+    if (dist[i] < INT_MAX)
+    {
+      precache_t entry = {i, dist[i]};
+      array_push(precache_queue, entry);
+    }
+
+  Z_Free(dist);
+
+  qsort(precache_queue, array_size(precache_queue), sizeof(*precache_queue),
+        ComparePrecache);
+}
+
+void R_UpdatePrecache(void)
+{
+  const uint64_t start = I_GetTimeUS();
+
+  while (precache_next < array_size(precache_queue))
+  {
+    R_PrecacheComposite(precache_queue[precache_next++].texnum);
+
+    if (I_GetTimeUS() - start >= PRECACHE_BUDGET_US)
+      break;
+  }
+}
 
 void R_PrecacheLevel(void)
 {
   register int i;
   register byte *hitlist;
 
-  if (demoplayback)
+  if (composites_precached || composites_ondemand)
+    I_Printf(VB_DEBUG, "R_PrecacheLevel: Previous level composites: "
+             "%d precached, %d on demand",
+             composites_precached, composites_ondemand);
+
+  composites_precached = composites_ondemand = 0;
+
+  array_clear(precache_queue);
+  precache_next = 0;
+
+  if (demoplayback || !precache)
+  {
+    R_QueuePrecache();
     return;
+  }
 
   {
     size_t size = numflats > num_sprites  ? numflats : num_sprites;
@@ -1248,14 +1443,10 @@ void R_PrecacheLevel(void)
     hitlist[sky->background.texture] = 1;
   }
 
+  // Generating the composite caches all of the texture's patches.
   for (i = numtextures; --i >= 0; )
     if (hitlist[i])
-      {
-        texture_t *texture = textures[i];
-        int j = texture->patchcount;
-        while (--j >= 0)
-          V_CachePatchNum(texture->patches[j].patch, PU_CACHE);
-      }
+      R_PrecacheComposite(i);
 
   // Precache sprites.
   memset(hitlist, 0, num_sprites);
@@ -52,6 +52,7 @@ byte *R_GetColumnMasked(int tex, int col);
 // I/O, setting up the stuff.
 void R_InitData (void);
 void R_PrecacheLevel (void);
+void R_UpdatePrecache (void);
 
 // Retrieval.
 // Floor/ceiling opaque texture tiles,
@@ -30,7 +30,9 @@
 #include "doomdata.h"
 #include "doomdef.h"
 #include "doomstat.h"
+#include "i_timer.h"
 #include "i_video.h"
+#include "m_profile.h"
 #include "p_mobj.h"
 #include "p_pspr.h"
 #include "p_setup.h" // P_SegLengths
@@ -681,14 +683,25 @@ void R_ExecuteSetViewSize (void)
 // R_Init
 //
 
+arena_t *frame_arena;
+
 void R_Init (void)
 {
+  #define SIZE_MB(x) ((x) * 1024 * 1024)
+  frame_arena = M_InitArena(SIZE_MB(256), SIZE_MB(1));
+
+  M_BeginProfile("R_InitData");
   R_InitData();
+  M_EndProfile();
   R_SetViewSize(screenblocks);
   R_InitPlanes();
+  M_BeginProfile("R_InitLightTables");
   R_InitLightTables();
+  M_EndProfile();
   R_InitTranslationTables();
+  M_BeginProfile("V_InitFlexTranTable");
   V_InitFlexTranTable();
+  M_EndProfile();
 
   // [FG] spectre drawing mode
   R_SetFuzzColumnMode();
@@ -881,6 +894,9 @@ void R_SetupFrame (player_t *player)
 //
 
 int rendered_visplanes, rendered_segs, rendered_vissprites, rendered_voxels;
+int rendered_drawsegs, rendered_openings;
+int rendertime; // [us]
+int rendered_frames, rendered_alloc_frames, rendered_allocs;
 
 static void R_ClearStats(void)
 {
@@ -888,6 +904,20 @@ static void R_ClearStats(void)
   rendered_segs = 0;
   rendered_vissprites = 0;
   rendered_voxels = 0;
+  rendered_drawsegs = 0;
+  rendered_openings = 0;
+}
+
+static void R_FinishStats(uint64_t starttime, size_t allocs)
+{
+  rendertime = I_GetTimeUS() - starttime;
+
+  rendered_frames++;
+  if (zone_allocs != allocs)
+  {
+    rendered_alloc_frames++;
+    rendered_allocs += zone_allocs - allocs;
+  }
 }
 
 static boolean flashing_hom;
@@ -898,8 +928,16 @@ int autodetect_hom = 0;       // killough 2/7/98: HOM autodetection flag
 //
 void R_RenderPlayerView (player_t* player)
 {       
+  const uint64_t starttime = I_GetTimeUS();
+  const size_t allocs = zone_allocs;
+
   R_ClearStats();
 
+  M_ClearArena(frame_arena);
+
+  // generate queued texture composites within the per-frame budget
+  R_UpdatePrecache();
+
   R_SetupFrame (player);
 
   // Clear buffers.
@@ -987,9 +1025,15 @@ void R_RenderPlayerView (player_t* player)
 
   R_NearbySprites ();
 
+  rendered_drawsegs = ds_p - drawsegs;
+  rendered_openings = lastopening - openings;
+
   // [FG] update automap while playing
   if (automap_on)
+  {
+    R_FinishStats(starttime, allocs);
     return;
+  }
 
   // Check for new console commands.
   NetUpdate ();
@@ -1005,6 +1049,8 @@ void R_RenderPlayerView (player_t* player)
 
   // Check for new console commands.
   NetUpdate ();
+
+  R_FinishStats(starttime, allocs);
 }
 
 void R_InitAnyRes(void)
@@ -1025,6 +1071,8 @@ void R_BindRenderVariables(void)
   BIND_BOOL_GENERAL(smoothlight, false, "Smooth diminishing lighting");
   M_BindBool("voxels_rendering", &default_voxels_rendering, &voxels_rendering,
              true, ss_none, wad_no, "Allow voxel models");
+  BIND_NUM(voxels_cache_size, 64, 0, 1024,
+    "Memory for decoded voxel models in MiB (0 = Unlimited)");
   BIND_BOOL_GENERAL(brightmaps, false,
     "Brightmaps for textures and sprites");
   BIND_NUM_GENERAL(invul_mode, INVUL_MBF, INVUL_VANILLA, INVUL_GRAY,
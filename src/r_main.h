@@ -21,6 +21,7 @@
 #define __R_MAIN__
 
 #include "doomtype.h"
+#include "m_arena.h"
 #include "m_fixed.h"
 #include "tables.h"
 
@@ -53,6 +54,14 @@ extern int      max_project_slope;
 //
 
 extern int rendered_visplanes, rendered_segs, rendered_vissprites, rendered_voxels;
+extern int rendered_drawsegs, rendered_openings;
+extern int rendertime; // [us]
+
+// zone allocations during R_RenderPlayerView, for -timedemo
+extern int rendered_frames, rendered_alloc_frames, rendered_allocs;
+
+// transient per-frame renderer data, cleared at the start of each frame
+extern arena_t *frame_arena;
 
 void R_BindRenderVariables(void);
 
@@ -270,9 +270,10 @@ static visplane_t *new_visplane(unsigned hash)
   visplane_t *check = freetail;
   if (!check)
   {
-    const int size = sizeof(*check) + (video.width * 2) * sizeof(*check->top);
+    // sized by pitch, so dynamic resolution changes can keep the pool
+    const int size = sizeof(*check) + (video.pitch * 2) * sizeof(*check->top);
     check = Z_Calloc(1, size, PU_VALLOC, NULL);
-    check->bottom = &check->top[video.width + 2];
+    check->bottom = &check->top[video.pitch + 2];
   }
   else
     if (!(freetail = freetail->next))
@@ -23,6 +23,8 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <SDL3/SDL.h>
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -31,7 +33,6 @@
 #include "i_video.h"
 #include "m_array.h"
 #include "m_fixed.h"
-#include "m_random.h"
 #include "r_data.h"
 #include "r_plane.h"
 #include "r_sky.h"
@@ -52,62 +53,165 @@ sky_t *levelskies = NULL;
 static skydefs_t *skydefs;
 
 // PSX fire sky, description: https://fabiensanglard.net/doom_fire_psx/
-static void SpreadFire(int src, byte *fire, int width)
+//
+// The fire is simulated one step ahead on a worker thread: while the current
+// state is displayed, the next one is computed into a back buffer and swapped
+// in at the tic it is due. Each sky has its own random number sequence, so
+// the result does not depend on thread timing.
+
+typedef struct firesky_s
+{
+    byte *fire; // displayed state
+    byte *next; // next state, written by the worker thread
+    int width;
+    int height;
+    uint32_t seed;
+    boolean pending; // protected by fire_mutex
+} firesky_t;
+
+static SDL_Thread *fire_thread;
+static SDL_Mutex *fire_mutex;
+static SDL_Condition *fire_cond;
+static firesky_t **fire_queue;
+
+static int FireRandom(firesky_t *fire)
 {
-    const byte pixel = fire[src];
+    fire->seed = fire->seed * 1664525u + 1013904223u;
+    return fire->seed >> 24;
+}
+
+static void SpreadFire(firesky_t *fire, int src, byte *data)
+{
+    const int width = fire->width;
+    const byte pixel = data[src];
     const int copyloc0 = src - width;
 
     if (pixel == 0)
     {
         if (copyloc0 >= 0)
         {
-            fire[copyloc0] = 0;
+            data[copyloc0] = 0;
         }
     }
     else
     {
-        const int rand = M_Random() & 3;
+        const int rand = FireRandom(fire) & 3;
         const int copyloc1 = copyloc0 - rand + 1;
 
         if (copyloc1 >= 0)
         {
-            fire[copyloc1] = pixel - (rand & 1);
+            data[copyloc1] = pixel - (rand & 1);
         }
     }
 }
 
-static void UpdateFireSky(sky_t *sky)
+static void StepFireSky(firesky_t *fire, byte *data)
 {
     // the fire algorithm affects multiple columns at once, therefore both XY
     // loops _must_ be separated, otherwise it will cause noticeable visual
     // disturbance on the resulting fire effect
 
-    const int texnum = sky->background.texture;
-    int height = textures[texnum]->height;
-    int width = textures[texnum]->width;
-    byte *coldata;
+    for (int x = 0; x < fire->width; x++)
+    {
+        for (int y = 1; y < fire->height; y++)
+        {
+            int src = y * fire->width + x;
+            SpreadFire(fire, src, data);
+        }
+    }
+}
 
-    for (int x = 0; x < width; x++)
+static int FireThread(void *unused)
+{
+    SDL_LockMutex(fire_mutex);
+
+    while (true)
     {
-        for (int y = 1; y < height; y++)
+        while (array_size(fire_queue) == 0)
         {
-            int src = y * width + x;
-            SpreadFire(src, sky->fire, width);
+            SDL_WaitCondition(fire_cond, fire_mutex);
         }
+
+        firesky_t *fire = fire_queue[0];
+        array_delete(fire_queue, 0);
+
+        SDL_UnlockMutex(fire_mutex);
+
+        memcpy(fire->next, fire->fire, fire->width * fire->height);
+        StepFireSky(fire, fire->next);
+
+        SDL_LockMutex(fire_mutex);
+        fire->pending = false;
+        SDL_BroadcastCondition(fire_cond);
     }
 
-    for (int x = 0; x < width; x++)
+    return 0;
+}
+
+static void QueueFireSky(firesky_t *fire)
+{
+    if (!fire_thread)
+    {
+        memcpy(fire->next, fire->fire, fire->width * fire->height);
+        StepFireSky(fire, fire->next);
+        return;
+    }
+
+    SDL_LockMutex(fire_mutex);
+    fire->pending = true;
+    array_push(fire_queue, fire);
+    SDL_BroadcastCondition(fire_cond);
+    SDL_UnlockMutex(fire_mutex);
+}
+
+static void WaitFireSky(firesky_t *fire)
+{
+    if (!fire_thread)
+    {
+        return;
+    }
+
+    SDL_LockMutex(fire_mutex);
+    while (fire->pending)
+    {
+        SDL_WaitCondition(fire_cond, fire_mutex);
+    }
+    SDL_UnlockMutex(fire_mutex);
+}
+
+static void DrawFireSky(sky_t *sky)
+{
+    const firesky_t *fire = sky->fire;
+    const int texnum = sky->background.texture;
+    byte *coldata;
+
+    for (int x = 0; x < fire->width; x++)
     {
         coldata = R_GetColumn(texnum, x);
 
-        for (int y = 0; y < height; y++)
+        for (int y = 0; y < fire->height; y++)
         {
-            int src = y * width + x;
-            coldata[y] = sky->palette[sky->fire[src]];
+            int src = y * fire->width + x;
+            coldata[y] = sky->palette[fire->fire[src]];
         }
     }
 }
 
+static void UpdateFireSky(sky_t *sky)
+{
+    firesky_t *fire = sky->fire;
+
+    WaitFireSky(fire);
+
+    byte *tmp = fire->fire;
+    fire->fire = fire->next;
+    fire->next = tmp;
+
+    DrawFireSky(sky);
+
+    QueueFireSky(fire);
+}
+
 static void R_InitFireSky(sky_t *sky)
 {
     int texnum = sky->background.texture;
@@ -115,17 +219,38 @@ static void R_InitFireSky(sky_t *sky)
     size_t size = tex->width * tex->height;
     int arr_size = array_size(sky->palette);
 
-    sky->fire = Z_Calloc(1, size, PU_STATIC, NULL);
+    if (!fire_mutex)
+    {
+        fire_mutex = SDL_CreateMutex();
+        fire_cond = SDL_CreateCondition();
+
+        if (fire_mutex && fire_cond)
+        {
+            fire_thread = SDL_CreateThread(FireThread, "fire sky", NULL);
+        }
+    }
+
+    firesky_t *fire = Z_Calloc(1, sizeof(*fire), PU_STATIC, NULL);
+    fire->fire = Z_Calloc(1, size, PU_STATIC, NULL);
+    fire->next = Z_Calloc(1, size, PU_STATIC, NULL);
+    fire->width = tex->width;
+    fire->height = tex->height;
+    fire->seed = texnum;
+    sky->fire = fire;
 
     for (int i = 0; i < tex->width; i++)
     {
-        sky->fire[(tex->height - 1) * tex->width + i] = arr_size - 1;
+        fire->fire[(tex->height - 1) * tex->width + i] = arr_size - 1;
     }
 
     for (int i = 0; i < 64; i++)
     {
-        UpdateFireSky(sky);
+        StepFireSky(fire, fire->fire);
     }
+
+    DrawFireSky(sky);
+
+    QueueFireSky(fire);
 }
 
 void R_InitSkyMap(void)
@@ -243,6 +368,9 @@ void R_ClearLevelskies(void)
     {
         if (sky->fire)
         {
+            WaitFireSky(sky->fire);
+            Z_Free(sky->fire->fire);
+            Z_Free(sky->fire->next);
             Z_Free(sky->fire);
         }
     }
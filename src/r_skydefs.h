@@ -47,7 +47,7 @@ typedef struct sky_s
     skytex_t background;
 
     // Type 1 -- Fire
-    byte*   fire;
+    struct firesky_s *fire;
     byte*   palette;
     int32_t updatetime;
     int32_t tics_left;
@@ -23,6 +23,8 @@
 #include "doomtype.h"
 #include "i_system.h"
 #include "m_fixed.h"
+#include "r_data.h"
+#include "r_state.h"
 #include "tables.h"
 #include "v_fmt.h"
 #include "z_zone.h"
@@ -86,17 +88,37 @@ static void R_InitDistortedFlats()
     }
 }
 
+// Each swirling flat keeps its own distorted copy, so that several liquid
+// flats visible in the same frame are distorted at most once per tic.
+
+typedef struct
+{
+    int swirltic;
+    byte *data;
+} swirlcache_t;
+
+static swirlcache_t *swirlcache = NULL;
+
 byte *R_DistortedFlat(int flatnum)
 {
     static int swirltic = -1;
-    static int swirlflat = -1;
-    static byte distortedflat[FLATSIZE];
 
     if (!offsets)
     {
         R_InitDistortedFlats();
     }
 
+    if (!swirlcache)
+    {
+        swirlcache = Z_Malloc(numflats * sizeof(*swirlcache), PU_STATIC, 0);
+
+        for (int i = 0; i < numflats; i++)
+        {
+            swirlcache[i].swirltic = -1;
+            swirlcache[i].data = NULL;
+        }
+    }
+
     if (swirltic != leveltime)
     {
         if (!frozen_mode)
@@ -109,25 +131,31 @@ byte *R_DistortedFlat(int flatnum)
         }
 
         swirltic = leveltime;
-        swirlflat = -1;
     }
 
-    if (swirlflat != flatnum)
+    swirlcache_t *cache = &swirlcache[flatnum - firstflat];
+
+    if (!cache->data)
+    {
+        cache->data = Z_Malloc(FLATSIZE, PU_STATIC, 0);
+    }
+
+    if (cache->swirltic != swirltic)
     {
-        char *normalflat;
+        byte *normalflat;
         int i;
 
         normalflat = V_CacheFlatNum(flatnum, PU_STATIC);
 
         for (i = 0; i < FLATSIZE; i++)
         {
-            distortedflat[i] = normalflat[offset[i]];
+            cache->data[i] = normalflat[offset[i]];
         }
 
         Z_ChangeTag(normalflat, PU_CACHE);
 
-        swirlflat = flatnum;
+        cache->swirltic = swirltic;
     }
 
-    return distortedflat;
+    return cache->data;
 }
@@ -90,7 +90,7 @@ typedef struct drawsegs_xrange_s
 static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
 
 static drawseg_xrange_item_t *drawsegs_xrange;
-static unsigned int drawsegs_xrange_size = 0;
+static int drawsegs_xrange_size = 0;
 static int drawsegs_xrange_count = 0;
 
 // [FG] 32-bit integer math
@@ -309,7 +309,7 @@ void R_InitSpriteDefs(char **namelist)
 //
 
 static vissprite_t *vissprites, **vissprite_ptrs;  // killough
-static size_t num_vissprite, num_vissprite_alloc, num_vissprite_ptrs;
+static size_t num_vissprite, num_vissprite_alloc = 128;
 
 #define M_ARRAY_INIT_CAPACITY 128
 #include "m_array.h"
@@ -338,6 +338,9 @@ void R_ClearSprites (void)
 {
   rendered_vissprites = num_vissprite;
   num_vissprite = 0;            // killough
+
+  // keep the capacity of the last frames, steady state needs no growth
+  vissprites = arena_alloc(frame_arena, num_vissprite_alloc, vissprite_t);
 }
 
 //
@@ -348,8 +351,9 @@ vissprite_t *R_NewVisSprite(void)
 {
   if (num_vissprite >= num_vissprite_alloc)             // killough
     {
-      num_vissprite_alloc = num_vissprite_alloc ? num_vissprite_alloc*2 : 128;
-      vissprites = Z_Realloc(vissprites,num_vissprite_alloc*sizeof(*vissprites),PU_STATIC,0);
+      vissprites = arena_realloc(frame_arena, vissprites, num_vissprite_alloc,
+                                 num_vissprite_alloc * 2, vissprite_t);
+      num_vissprite_alloc *= 2;
     }
  return vissprites + num_vissprite++;
 }
@@ -1002,16 +1006,10 @@ void R_SortVisSprites (void)
     {
       int i = num_vissprite;
 
-      // If we need to allocate more pointers for the vissprites,
-      // allocate as many as were allocated for sprites -- killough
-      // killough 9/22/98: allocate twice as many
-
-      if (num_vissprite_ptrs < num_vissprite*2)
-        {
-          Z_Free(vissprite_ptrs);  // better than realloc -- no preserving needed
-          vissprite_ptrs = Z_Malloc((num_vissprite_ptrs = num_vissprite_alloc*2)
-                                  * sizeof *vissprite_ptrs, PU_STATIC, 0);
-        }
+      // killough 9/22/98: allocate twice as many, the second half is the
+      // scratch space of msort
+      vissprite_ptrs =
+          arena_alloc(frame_arena, num_vissprite * 2, vissprite_t *);
 
       // Sprites of equal distance need to be sorted in inverse order.
       // This is most easily achieved by filling the sort array
@@ -1193,16 +1191,11 @@ void R_DrawMasked(void)
 
   if (num_vissprite > 0)
   {
-    if (drawsegs_xrange_size < maxdrawsegs)
+    drawsegs_xrange_size = ds_p - drawsegs;
+    for(i = 0; i < DS_RANGES_COUNT; i++)
     {
-      drawsegs_xrange_size = 2 * maxdrawsegs;
-      for(i = 0; i < DS_RANGES_COUNT; i++)
-      {
-        drawsegs_xranges[i].items = Z_Realloc(
-          drawsegs_xranges[i].items,
-          drawsegs_xrange_size * sizeof(drawsegs_xranges[i].items[0]),
-          PU_STATIC, 0);
-      }
+      drawsegs_xranges[i].items = arena_alloc(frame_arena,
+        drawsegs_xrange_size, drawseg_xrange_item_t);
     }
     for (ds = ds_p; ds-- > drawsegs;)
     {
@@ -12,6 +12,8 @@
 // GNU General Public License for more details.
 //
 
+#include <SDL3/SDL.h>
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -26,6 +28,7 @@
 #include "mn_menu.h"
 #include "m_misc.h"
 #include "p_mobj.h"
+#include "p_tick.h"
 #include "r_bmaps.h"
 #include "r_defs.h"
 #include "r_draw.h"
@@ -40,6 +43,9 @@
 static boolean voxels_found;
 boolean voxels_rendering, default_voxels_rendering;
 
+// memory for decoded models, least recently drawn ones are freed first
+int voxels_cache_size = 64; // [MiB], 0 is unlimited
+
 struct Voxel
 {
 	int  x_size;
@@ -56,7 +62,42 @@ struct Voxel
 
 #define MAX_FRAMES  29
 
-static struct Voxel *** all_voxels;
+// Models are decoded on first use, or ahead of it by the decoder thread for
+// the things of the current level.
+
+enum VoxelState
+{
+	VX_NOLUMP,
+	VX_UNLOADED,
+	VX_QUEUED,  // owned by the decoder thread
+	VX_READY,
+	VX_INVALID,
+};
+
+typedef struct
+{
+	struct Voxel * model;
+	SDL_AtomicInt  state;
+
+	int     lumpnum;
+	byte  * lump;    // raw data for the decoder thread
+	int     length;
+
+	size_t        size;
+	unsigned int  lastused;
+} voxelslot_t;
+
+static voxelslot_t ** all_voxels;
+
+static byte vx_playpal[768];
+
+static SDL_Thread * decode_thread;
+static SDL_Mutex * decode_mutex;
+static SDL_Condition * decode_cond;
+static voxelslot_t ** decode_queue;
+
+static size_t cache_bytes;
+static unsigned int vx_frame;
 
 #define VX_ITEM_ROTATION_ANGLE (4 * ANG1)
 
@@ -75,7 +116,7 @@ enum VoxelFace
 };
 
 
-static int VX_PaletteIndex (byte * pal, int r, int g, int b)
+static int VX_PaletteIndex (const byte * pal, int r, int g, int b)
 {
 	int best = 0;
 	int best_dist = (1 << 30);
@@ -102,7 +143,7 @@ static int VX_PaletteIndex (byte * pal, int r, int g, int b)
 
 static void VX_CreateRemapTable (byte * p, byte * table)
 {
-	byte * pal = W_CacheLumpName ("PLAYPAL", PU_CACHE);
+	const byte * pal = vx_playpal;
 
 	int c;
 	for (c = 0 ; c < 256 ; c++)
@@ -145,7 +186,17 @@ static void VX_RemapSlabColors (struct Voxel * v, int x, int y, byte * table)
 }
 
 
-static struct Voxel * VX_Decode (byte * p, int length)
+static void VX_FreeVoxel (struct Voxel * v)
+{
+	free (v->offsets);
+	free (v->data);
+	free (v);
+}
+
+
+// Runs on the decoder thread as well, so it must not use the zone or print.
+
+static struct Voxel * VX_Decode (byte * p, int length, size_t * size)
 {
 	// too short?
 	if (length < 40 + 768)
@@ -153,7 +204,7 @@ static struct Voxel * VX_Decode (byte * p, int length)
 
 	byte * orig_p = p;
 
-	struct Voxel * v = Z_Malloc (sizeof(struct Voxel), PU_STATIC, NULL);
+	struct Voxel * v = calloc (1, sizeof(struct Voxel));
 
 	// skip num_bytes
 	p += 4;
@@ -163,7 +214,10 @@ static struct Voxel * VX_Decode (byte * p, int length)
 	v->z_size = (int)p[0];  p += 4;
 
 	if (v->x_size == 0 || v->y_size == 0 || v->z_size == 0)
+	{
+		VX_FreeVoxel (v);
 		return NULL;
+	}
 
 	v->x_pivot = (p[0] << 8) | (p[1] << 16);  p += 4;
 	v->y_pivot = (p[0] << 8) | (p[1] << 16);  p += 4;
@@ -184,7 +238,7 @@ static struct Voxel * VX_Decode (byte * p, int length)
 	int min_offset = (1 << 30);
 	int max_offset = 0;
 
-	v->offsets = Z_Malloc (sizeof(int) * num_offsets, PU_STATIC, NULL);
+	v->offsets = malloc (sizeof(int) * num_offsets);
 
 	for (x = 0 ; x < v->x_size ; x++)
 	{
@@ -205,7 +259,10 @@ static struct Voxel * VX_Decode (byte * p, int length)
 
 	int data_size = max_offset - min_offset;
 	if (data_size <= 0)
+	{
+		VX_FreeVoxel (v);
 		return NULL;
+	}
 
 	for (x = 0 ; x < num_offsets ; x++)
 		v->offsets[x] -= min_offset;
@@ -213,7 +270,7 @@ static struct Voxel * VX_Decode (byte * p, int length)
 	// copy the slab data
 	p = orig_p + (7 * 4) + min_offset;
 
-	v->data = Z_Malloc (data_size, PU_STATIC, NULL);
+	v->data = malloc (data_size);
 
 	memcpy (v->data, p, data_size);
 
@@ -232,68 +289,249 @@ static struct Voxel * VX_Decode (byte * p, int length)
 		}
 	}
 
+	*size = sizeof(struct Voxel) + sizeof(int) * num_offsets + data_size;
+
 	return v;
 }
 
 
-static boolean VX_Load (int spr, int frame)
+static void VX_DecodeSlot (voxelslot_t * slot)
 {
-	char frame_ch = 'A' + frame;
+	size_t size = 0;
 
-	if (frame_ch == '\\')
-		frame_ch = '^';
+	// Note: this may return NULL
+	struct Voxel * v = VX_Decode (slot->lump, slot->length, &size);
 
-	char lumpname[9] = {0};
+	free (slot->lump);
+	slot->lump = NULL;
 
-	M_snprintf (lumpname, sizeof(lumpname), "%s%c", sprnames[spr], frame_ch);
+	SDL_LockMutex (decode_mutex);
 
-	int lumpnum = (W_CheckNumForName)(lumpname, ns_voxels);
+	slot->model = v;
+	slot->size  = size;
+	cache_bytes += size;
+	SDL_SetAtomicInt (&slot->state, v ? VX_READY : VX_INVALID);
 
-	if (lumpnum < 0)
+	SDL_BroadcastCondition (decode_cond);
+	SDL_UnlockMutex (decode_mutex);
+}
+
+
+static int VX_DecodeThread (void * unused)
+{
+	SDL_LockMutex (decode_mutex);
+
+	while (true)
 	{
-		return false;
+		while (array_size (decode_queue) == 0)
+		{
+			SDL_WaitCondition (decode_cond, decode_mutex);
+		}
+
+		voxelslot_t * slot = decode_queue[0];
+		array_delete (decode_queue, 0);
+
+		SDL_UnlockMutex (decode_mutex);
+		VX_DecodeSlot (slot);
+		SDL_LockMutex (decode_mutex);
 	}
 
-	byte *buf = W_CacheLumpNum(lumpnum, PU_STATIC);
-	int len   = W_LumpLength(lumpnum);
+	return 0;
+}
 
-	// Note: this may return NULL
-	struct Voxel * v = VX_Decode (buf, len);
 
-	if (v != NULL)
-		voxels_found = true;
+static void VX_ReadLump (voxelslot_t * slot)
+{
+	slot->length = W_LumpLength (slot->lumpnum);
+	slot->lump   = malloc (slot->length);
 
-	all_voxels[spr][frame] = v;
+	W_ReadLump (slot->lumpnum, slot->lump);
+}
 
-	Z_Free (buf);
 
-	return true;
+static void VX_QueueVoxel (voxelslot_t * slot)
+{
+	VX_ReadLump (slot);
+	slot->lastused = vx_frame;
+
+	SDL_LockMutex (decode_mutex);
+	SDL_SetAtomicInt (&slot->state, VX_QUEUED);
+	array_push (decode_queue, slot);
+	SDL_BroadcastCondition (decode_cond);
+	SDL_UnlockMutex (decode_mutex);
 }
 
 
-void VX_Init (void)
+static int VX_CompareLastUsed (const void * a, const void * b)
 {
+	const voxelslot_t * sa = *(voxelslot_t * const *)a;
+	const voxelslot_t * sb = *(voxelslot_t * const *)b;
+
+	return (sa->lastused > sb->lastused) - (sa->lastused < sb->lastused);
+}
+
+
+// free the least recently drawn models, but none drawn in this frame
+
+static void VX_EvictVoxels (void)
+{
+	const size_t budget = (size_t)voxels_cache_size << 20;
+	voxelslot_t ** lru = NULL;
 	int spr, frame;
 
-	all_voxels = Z_Malloc(num_sprites * sizeof(*all_voxels), PU_STATIC, NULL);
+	if (budget == 0)
+		return;
+
+	SDL_LockMutex (decode_mutex);
+	const boolean over = cache_bytes > budget;
+	SDL_UnlockMutex (decode_mutex);
+
+	if (! over)
+		return;
+
 	for (spr = 0 ; spr < num_sprites ; spr++)
 	{
-		all_voxels[spr] = Z_Malloc (MAX_FRAMES * sizeof(**all_voxels),
-					    PU_STATIC, NULL);
 		for (frame = 0 ; frame < MAX_FRAMES ; frame++)
 		{
-			all_voxels[spr][frame] = NULL;
+			voxelslot_t * slot = &all_voxels[spr][frame];
+
+			if (SDL_GetAtomicInt (&slot->state) == VX_READY
+			    && slot->lastused != vx_frame)
+			{
+				array_push (lru, slot);
+			}
+		}
+	}
+
+	qsort (lru, array_size (lru), sizeof(*lru), VX_CompareLastUsed);
+
+	voxelslot_t ** slot;
+	array_foreach (slot, lru)
+	{
+		SDL_LockMutex (decode_mutex);
+
+		if (cache_bytes <= budget)
+		{
+			SDL_UnlockMutex (decode_mutex);
+			break;
+		}
+
+		cache_bytes -= (*slot)->size;
+
+		SDL_UnlockMutex (decode_mutex);
+
+		VX_FreeVoxel ((*slot)->model);
+		(*slot)->model = NULL;
+		SDL_SetAtomicInt (&(*slot)->state, VX_UNLOADED);
+	}
+
+	array_free (lru);
+}
+
+
+static struct Voxel * VX_GetVoxel (int spr, int frame)
+{
+	voxelslot_t * slot = &all_voxels[spr][frame];
+
+	switch (SDL_GetAtomicInt (&slot->state))
+	{
+		case VX_UNLOADED:
+			VX_ReadLump (slot);
+			VX_DecodeSlot (slot);
+			break;
+
+		case VX_QUEUED:
+			SDL_LockMutex (decode_mutex);
+			while (SDL_GetAtomicInt (&slot->state) == VX_QUEUED)
+			{
+				SDL_WaitCondition (decode_cond, decode_mutex);
+			}
+			SDL_UnlockMutex (decode_mutex);
+			break;
+	}
+
+	slot->lastused = vx_frame;
+
+	return slot->model;
+}
+
+
+void VX_PrecacheLevel (void)
+{
+	byte * hitlist;
+	int spr, frame;
+
+	if (! voxels_found || ! STRICTMODE(voxels_rendering) || ! decode_thread)
+		return;
+
+	hitlist = Z_Calloc (num_sprites, 1, PU_STATIC, NULL);
+
+	thinker_t * th;
+	for (th = thinkercap.next ; th != &thinkercap ; th = th->next)
+	{
+		if (th->function.pm == P_MobjThinker)
+			hitlist[((mobj_t *)th)->sprite] = 1;
+	}
+
+	// the level's models are kept over the ones drawn before
+	vx_frame++;
+
+	for (spr = 0 ; spr < num_sprites ; spr++)
+	{
+		if (! hitlist[spr])
+			continue;
+
+		for (frame = 0 ; frame < MAX_FRAMES ; frame++)
+		{
+			voxelslot_t * slot = &all_voxels[spr][frame];
+
+			if (SDL_GetAtomicInt (&slot->state) == VX_UNLOADED)
+				VX_QueueVoxel (slot);
+			else
+				slot->lastused = vx_frame;
 		}
 	}
 
+	Z_Free (hitlist);
+}
+
+
+void VX_Init (void)
+{
+	int spr, frame;
+
+	all_voxels = Z_Malloc(num_sprites * sizeof(*all_voxels), PU_STATIC, NULL);
+	for (spr = 0 ; spr < num_sprites ; spr++)
+	{
+		all_voxels[spr] = Z_Calloc (MAX_FRAMES, sizeof(**all_voxels),
+					    PU_STATIC, NULL);
+	}
+
 	I_Printf(VB_INFO, "Loading voxels... ");
 
+	// only look up the lumps, the models are decoded when needed
 	for (spr = 0 ; spr < num_sprites ; spr++)
 	{
 		for (frame = 0 ; frame < MAX_FRAMES ; frame++)
 		{
-			if (! VX_Load (spr, frame))
+			char frame_ch = 'A' + frame;
+
+			if (frame_ch == '\\')
+				frame_ch = '^';
+
+			char lumpname[9] = {0};
+
+			M_snprintf (lumpname, sizeof(lumpname), "%s%c", sprnames[spr], frame_ch);
+
+			int lumpnum = (W_CheckNumForName)(lumpname, ns_voxels);
+
+			if (lumpnum < 0)
 				break;
+
+			all_voxels[spr][frame].lumpnum = lumpnum;
+			SDL_SetAtomicInt (&all_voxels[spr][frame].state, VX_UNLOADED);
+
+			voxels_found = true;
 		}
 	}
 
@@ -307,6 +545,17 @@ void VX_Init (void)
 	}
 	else
 	{
+		byte * pal = W_CacheLumpName ("PLAYPAL", PU_CACHE);
+		memcpy (vx_playpal, pal, sizeof(vx_playpal));
+
+		decode_mutex = SDL_CreateMutex ();
+		decode_cond  = SDL_CreateCondition ();
+
+		if (decode_mutex && decode_cond)
+		{
+			decode_thread = SDL_CreateThread (VX_DecodeThread, "voxel decoder", NULL);
+		}
+
 		I_Printf (VB_INFO, "done.");
 	}
 }
@@ -353,19 +602,17 @@ struct VisVoxel
 };
 
 static struct VisVoxel * visvoxels;
-static int num_visvoxels;
+static int num_visvoxels, max_visvoxels = 128;
 
 vissprite_t * R_NewVisSprite (void);
 
 static int VX_NewVisVoxel (void)
 {
-	static int size;
-
-	if (num_visvoxels >= size)
+	if (num_visvoxels >= max_visvoxels)
 	{
-		size = (size ? size * 2 : 128);
-		visvoxels = Z_Realloc (visvoxels, size * sizeof(*visvoxels),
-				       PU_STATIC, 0);
+		visvoxels = arena_realloc (frame_arena, visvoxels, max_visvoxels,
+					   max_visvoxels * 2, struct VisVoxel);
+		max_visvoxels *= 2;
 	}
 
 	return num_visvoxels++;
@@ -374,8 +621,16 @@ static int VX_NewVisVoxel (void)
 
 void VX_ClearVoxels (void)
 {
+	if (voxels_found)
+	{
+		VX_EvictVoxels ();
+		vx_frame++;
+	}
+
 	rendered_voxels = num_visvoxels;
 	num_visvoxels = 0;
+
+	visvoxels = arena_alloc (frame_arena, max_visvoxels, struct VisVoxel);
 }
 
 
@@ -512,7 +767,7 @@ boolean VX_ProjectVoxel (mobj_t * thing)
 	int spr   = thing->sprite;
 	int frame = thing->frame & FF_FRAMEMASK;
 
-	struct Voxel * v = all_voxels[spr][frame];
+	struct Voxel * v = VX_GetVoxel (spr, frame);
 	if (v == NULL)
 		return false;
 
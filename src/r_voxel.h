@@ -29,6 +29,11 @@ void VX_DrawVoxel (struct vissprite_s * vis);
 
 extern boolean voxels_rendering, default_voxels_rendering;
 
+extern int voxels_cache_size;
+
+// queue the models of the level's things for decoding
+void VX_PrecacheLevel (void);
+
 void VX_IncreaseMaxDist (void);
 
 void VX_DecreaseMaxDist (void);
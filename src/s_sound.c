@@ -30,11 +30,14 @@
 #include "i_rumble.h"
 #include "i_sound.h"
 #include "i_system.h"
+#include "info.h"
+#include "m_array.h"
 #include "m_config.h"
 #include "m_misc.h"
 #include "m_random.h"
 #include "p_ambient.h"
 #include "p_mobj.h"
+#include "p_tick.h"
 #include "s_musinfo.h" // [crispy] struct musinfo
 #include "s_sound.h"
 #include "s_trakinfo.h"
@@ -58,6 +61,8 @@ typedef struct channel_s
     int priority;         // current priority value
     int singularity;      // haleyjd 09/27/06: stored singularity value
     int volume;
+    int start;            // leveltime when the sound started
+    float pitch;
 } channel_t;
 
 // the set of channels available
@@ -65,6 +70,24 @@ static channel_t channels[MAX_CHANNELS];
 // [FG] removed map objects may finish their sounds
 static mobj_t sobjs[MAX_CHANNELS];
 
+// Sounds that lost their channel to higher priority sounds or by moving out
+// of range. They are tracked without a sound source and get a channel back
+// when one is free and they are audible before they would have ended.
+typedef struct
+{
+    sfxinfo_t *sfxinfo;
+    const mobj_t *origin;
+    int start;
+    int priority;
+    int singularity;
+    float pitch;
+} virtual_voice_t;
+
+#define MAX_VIRTUAL_VOICES 64
+
+static virtual_voice_t virtual_voices[MAX_VIRTUAL_VOICES];
+static int num_virtual_voices;
+
 // Pitch to stepping lookup.
 static float steptable[256];
 
@@ -125,6 +148,109 @@ static void ResetActive(void)
 // Internals.
 //
 
+// Length of the sound in seconds, loading it if it hasn't been precached.
+
+static float SoundLength(sfxinfo_t *sfx)
+{
+    while (sfx->link)
+    {
+        sfx = sfx->link;
+    }
+
+    if (!sfx->cached)
+    {
+        I_CacheSound(sfx);
+    }
+
+    return sfx->length;
+}
+
+// Position in the sound, in seconds of sample data.
+
+static float SoundElapsed(int start, float pitch)
+{
+    return (float)(leveltime - start) / TICRATE * pitch;
+}
+
+// A sound started after the current time was left behind by a key frame
+// load and counts as finished too.
+
+static boolean SoundFinished(sfxinfo_t *sfx, int start, float pitch)
+{
+    const float elapsed = SoundElapsed(start, pitch);
+
+    return elapsed < 0.0f || elapsed >= SoundLength(sfx);
+}
+
+static void RemoveVirtualVoice(int i)
+{
+    virtual_voices[i] = virtual_voices[--num_virtual_voices];
+}
+
+static void RemoveVirtualVoices(const mobj_t *origin, int singularity)
+{
+    for (int i = 0; i < num_virtual_voices;)
+    {
+        const virtual_voice_t *v = &virtual_voices[i];
+
+        if (v->origin == origin
+            && (singularity < 0 || v->singularity == singularity))
+        {
+            RemoveVirtualVoice(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+static void AddVirtualVoice(sfxinfo_t *sfx, const mobj_t *origin, int start,
+                            int priority, int singularity, float pitch)
+{
+    if (!snd_virtual_voices || !origin || sfx->looping
+        || SoundFinished(sfx, start, pitch))
+    {
+        return;
+    }
+
+    // Copies of removed map objects are reused with their channel.
+    if (origin >= sobjs && origin < sobjs + MAX_CHANNELS)
+    {
+        return;
+    }
+
+    int i = num_virtual_voices;
+
+    if (i == MAX_VIRTUAL_VOICES)
+    {
+        // Replace the lowest priority voice.
+        int lowest = 0;
+
+        for (int j = 1; j < num_virtual_voices; j++)
+        {
+            if (virtual_voices[j].priority > virtual_voices[lowest].priority)
+            {
+                lowest = j;
+            }
+        }
+
+        if (priority >= virtual_voices[lowest].priority)
+        {
+            return;
+        }
+
+        i = lowest;
+    }
+    else
+    {
+        num_virtual_voices++;
+    }
+
+    virtual_voices[i] = (virtual_voice_t){sfx, origin, start, priority,
+                                          singularity, pitch};
+}
+
 static void StopChannel(int cnum)
 {
     if (channels[cnum].sfxinfo)
@@ -151,9 +277,16 @@ static void S_EvictChannel(int cnum)
     }
 #endif
 
-    if (channels[cnum].ambient)
+    channel_t *c = &channels[cnum];
+
+    if (c->ambient)
+    {
+        P_EvictAmbientSound(c->ambient, c->handle);
+    }
+    else if (c->sfxinfo)
     {
-        P_EvictAmbientSound(channels[cnum].ambient, channels[cnum].handle);
+        AddVirtualVoice(c->sfxinfo, c->origin, c->start, c->o_priority,
+                        c->singularity, c->pitch);
     }
 
     StopChannel(cnum);
@@ -196,6 +329,15 @@ void S_EvictChannels(void)
     ResetActive();
     memset(channels, 0, sizeof(channels));
     memset(sobjs, 0, sizeof(sobjs));
+    num_virtual_voices = 0;
+}
+
+// Virtual voices refer to map objects and level time, which a key frame load
+// replaces.
+
+void S_ClearVirtualVoices(void)
+{
+    num_virtual_voices = 0;
 }
 
 //
@@ -213,53 +355,94 @@ static int S_AdjustSoundParams(const mobj_t *listener, const mobj_t *source,
     return I_AdjustSoundParams(listener, source, params);
 }
 
-static void LimitChannelsPerSfx(const mobj_t *origin, const sfxinfo_t *sfxinfo,
-                                int priority, int *cnum)
+// What S_getChannel needs to know about the channels in use, gathered in a
+// single pass.
+typedef struct
+{
+    int singular;     // channel of the same singularity class and origin
+    int open;         // first open channel
+    int lowest;       // channel with the lowest priority
+    int sfx_lowest;   // same, among the channels playing the sound
+    int sfx_channels; // number of channels playing the sound
+} channel_scan_t;
+
+static void ScanChannels(const mobj_t *origin, const sfxinfo_t *sfxinfo,
+                         int singularity, channel_scan_t *scan)
 {
-    if (max_channels_per_sfx < 1 || *cnum != snd_channels || !origin)
-    {
-        return;
-    }
-
     int lowestpriority = -1;
-    int lpcnum = -1;
-    int num_channels = 0;
+    int sfx_lowestpriority = -1;
+
+    scan->singular = -1;
+    scan->open = -1;
+    scan->lowest = -1;
+    scan->sfx_lowest = -1;
+    scan->sfx_channels = 0;
 
     for (int i = 0; i < snd_channels; i++)
     {
         const channel_t *c = &channels[i];
-        const sfxinfo_t *sfx = c->sfxinfo;
 
-        if (sfx && sfxinfo == sfx && c->origin)
+        if (!c->sfxinfo)
         {
-            // Find the lowest priority channel using the target sound.
-            if (c->priority > lowestpriority)
+            if (scan->open < 0)
             {
-                lowestpriority = c->priority;
-                lpcnum = i;
+                scan->open = i;
             }
+            continue;
+        }
 
-            // Find the number of channels using the target sound.
-            num_channels++;
+        // killough 12/98: replace is_pickup hack with singularity flag
+        // haleyjd 06/12/08: only if subchannel matches
+        if (scan->singular < 0 && c->singularity == singularity
+            && c->origin == origin)
+        {
+            scan->singular = i;
         }
-    }
 
-    if (num_channels >= max_channels_per_sfx)
-    {
-        if (priority > lowestpriority)
+        if (c->priority > lowestpriority)
         {
-            // The other channels have higher priority.
-            *cnum = -1;
+            lowestpriority = c->priority;
+            scan->lowest = i;
         }
-        else
+
+        if (c->sfxinfo == sfxinfo && c->origin)
         {
-            // Stop the lowest priority channel.
-            S_EvictChannel(lpcnum);
-            *cnum = lpcnum;
+            if (c->priority > sfx_lowestpriority)
+            {
+                sfx_lowestpriority = c->priority;
+                scan->sfx_lowest = i;
+            }
+            scan->sfx_channels++;
         }
     }
 }
 
+static boolean LimitChannelsPerSfx(const mobj_t *origin,
+                                   const channel_scan_t *scan)
+{
+    return (max_channels_per_sfx > 0 && origin && scan->singular < 0
+            && scan->sfx_channels >= max_channels_per_sfx);
+}
+
+// Check whether a sound can't get a channel even before its priority is
+// scaled by distance. The scaling only ever lowers the priority.
+
+static boolean S_RejectSound(const mobj_t *origin, const channel_scan_t *scan,
+                             int priority)
+{
+    if (scan->singular >= 0)
+    {
+        return false;
+    }
+
+    if (LimitChannelsPerSfx(origin, scan))
+    {
+        return priority > channels[scan->sfx_lowest].priority;
+    }
+
+    return scan->open < 0 && priority > channels[scan->lowest].priority;
+}
+
 //
 // S_getChannel :
 //
@@ -267,65 +450,46 @@ static void LimitChannelsPerSfx(const mobj_t *origin, const sfxinfo_t *sfxinfo,
 //   haleyjd 09/27/06: fixed priority/singularity bugs
 //   Note that a higher priority number means lower priority!
 //
-static int S_getChannel(const mobj_t *origin, const sfxinfo_t *sfxinfo,
-                        int priority, int singularity)
+static int S_getChannel(const mobj_t *origin, const channel_scan_t *scan,
+                        int priority)
 {
     // channel number to use
     int cnum;
-    int lowestpriority = -1; // haleyjd
-    int lpcnum = -1;
 
     // haleyjd 09/28/06: moved this here. If we kill a sound already
     // being played, we can use that channel. There is no need to
     // search for a free one again because we already know of one.
 
     // kill old sound
-    // killough 12/98: replace is_pickup hack with singularity flag
-    // haleyjd 06/12/08: only if subchannel matches
-    for (cnum = 0; cnum < snd_channels; cnum++)
+    if (scan->singular >= 0)
     {
-        if (channels[cnum].sfxinfo && channels[cnum].singularity == singularity
-            && channels[cnum].origin == origin)
-        {
-            S_StopChannel(cnum);
-            break;
-        }
+        cnum = scan->singular;
+        S_StopChannel(cnum);
     }
-
-    LimitChannelsPerSfx(origin, sfxinfo, priority, &cnum);
-
-    // Find an open channel
-    if (cnum == snd_channels)
+    else if (LimitChannelsPerSfx(origin, scan))
     {
-        // haleyjd 09/28/06: it isn't necessary to look for playing sounds in
-        // the same singularity class again, as we just did that above. Here
-        // we are looking for an open channel. We will also keep track of the
-        // channel found with the lowest sound priority while doing this.
-        for (cnum = 0; cnum < snd_channels && channels[cnum].sfxinfo; cnum++)
+        if (priority > channels[scan->sfx_lowest].priority)
         {
-            if (channels[cnum].priority > lowestpriority)
-            {
-                lowestpriority = channels[cnum].priority;
-                lpcnum = cnum;
-            }
+            // The other channels have higher priority.
+            return -1;
         }
-    }
 
-    // None available?
-    if (cnum == snd_channels)
+        // Stop the lowest priority channel using the target sound.
+        cnum = scan->sfx_lowest;
+        S_EvictChannel(cnum);
+    }
+    else if (scan->open >= 0)
     {
-        // Look for lower priority
-        // haleyjd: we have stored the channel found with the lowest priority
-        // in the loop above
-        if (priority > lowestpriority)
-        {
-            return -1; // No lower priority.  Sorry, Charlie.
-        }
-        else
-        {
-            S_EvictChannel(lpcnum); // Otherwise, kick out lowest priority.
-            cnum = lpcnum;
-        }
+        cnum = scan->open;
+    }
+    else if (priority > channels[scan->lowest].priority)
+    {
+        return -1; // No lower priority.  Sorry, Charlie.
+    }
+    else
+    {
+        cnum = scan->lowest;
+        S_EvictChannel(cnum); // Otherwise, kick out lowest priority.
     }
 
 #ifdef RANGECHECK
@@ -338,7 +502,10 @@ static int S_getChannel(const mobj_t *origin, const sfxinfo_t *sfxinfo,
     return cnum;
 }
 
-static void LimitVolumePerSfx(void)
+// Limit the total volume of each sound, or only of the given sound if it's
+// the only one whose channels have changed.
+
+static void LimitVolumePerSfx(const sfxinfo_t *only)
 {
     if (max_volume_per_sfx < 1)
     {
@@ -350,7 +517,7 @@ static void LimitVolumePerSfx(void)
         channel_t *c = &channels[cnum];
         sfxinfo_t *sfx = c->sfxinfo;
 
-        if (sfx)
+        if (sfx && (!only || sfx == only))
         {
             sfx->active.volume = 0;
         }
@@ -362,7 +529,8 @@ static void LimitVolumePerSfx(void)
         channel_t *c = &channels[cnum];
         sfxinfo_t *sfx = c->sfxinfo;
 
-        if (sfx && sfx->active.count > 1 && c->origin)
+        if (sfx && (!only || sfx == only) && sfx->active.count > 1
+            && c->origin)
         {
             sfx->active.volume += c->volume;
         }
@@ -375,7 +543,8 @@ static void LimitVolumePerSfx(void)
         channel_t *c = &channels[cnum];
         sfxinfo_t *sfx = c->sfxinfo;
 
-        if (sfx && sfx->active.volume > max_volume_per_sfx)
+        if (sfx && (!only || sfx == only)
+            && sfx->active.volume > max_volume_per_sfx)
         {
             const float gain = (float)c->volume * max_volume_per_sfx
                                / (127 * sfx->active.volume);
@@ -431,13 +600,86 @@ static float GetPitch(pitchrange_t pitch_range)
     }
 }
 
+// Start a sound on the channel returned by S_getChannel, right after its
+// parameters have been adjusted.
+
+static boolean StartChannel(int cnum, sfxinfo_t *sfx, const mobj_t *origin,
+                            sfxparams_t *params, int o_priority,
+                            int singularity, int start,
+                            rumble_type_t rumble_type, ambient_t *ambient)
+{
+    int handle;
+
+#ifdef RANGECHECK
+    if (cnum < 0 || cnum >= snd_channels)
+    {
+        I_Error("handle %d out of range\n", cnum);
+    }
+#endif
+
+    channels[cnum].sfxinfo = sfx;
+
+    while (sfx->link)
+    {
+        sfx = sfx->link; // sf: skip thru link(s)
+    }
+
+    if (ambient)
+    {
+        params->offset = GetAmbientSoundOffset(sfx, ambient);
+    }
+    else
+    {
+        params->offset = SoundElapsed(start, params->pitch);
+    }
+
+    // Assigns the handle to one of the channels in the mix/output buffer.
+    handle = I_StartSound(sfx, params);
+
+    // haleyjd: check to see if the sound was started
+    if (handle >= 0)
+    {
+        // haleyjd 05/29/06: record volume scale value
+        // haleyjd 09/27/06: store priority and singularity values (!!!)
+        channels[cnum].origin = origin;
+        channels[cnum].handle = handle;
+        channels[cnum].ambient = ambient;
+        channels[cnum].close_dist = params->close_dist;
+        channels[cnum].clipping_dist = params->clipping_dist;
+        channels[cnum].stop_dist = params->stop_dist;
+        channels[cnum].volume_scale = params->volume_scale;
+        channels[cnum].o_priority = o_priority;     // original priority
+        channels[cnum].priority = params->priority; // scaled priority
+        channels[cnum].singularity = singularity;
+        channels[cnum].volume = params->volume;
+        channels[cnum].start = start;
+        channels[cnum].pitch = params->pitch;
+        channels[cnum].sfxinfo->active.count++;
+        LimitVolumePerSfx(channels[cnum].sfxinfo);
+
+        if (rumble_type != RUMBLE_NONE)
+        {
+            I_StartRumble(players[displayplayer].mo, origin, sfx, handle,
+                          rumble_type);
+        }
+    }
+    else // haleyjd: the sound didn't start, so clear the channel info
+    {
+        memset(&channels[cnum], 0, sizeof(channel_t));
+        return false;
+    }
+
+    return true;
+}
+
 #define StartSound(o, i, p, r) StartSoundEx((o), (i), (p), (r), NULL)
 
 static boolean StartSoundEx(const mobj_t *origin, int sfx_id,
                             pitchrange_t pitch_range, rumble_type_t rumble_type,
                             ambient_t *ambient)
 {
-    int o_priority, singularity, cnum, handle;
+    int o_priority, singularity, cnum;
+    channel_scan_t scan;
     sfxparams_t params;
     sfxinfo_t *sfx;
 
@@ -481,72 +723,44 @@ static boolean StartSoundEx(const mobj_t *origin, int sfx_id,
     o_priority = params.priority = sfx->priority;
     singularity = sfx->singularity;
 
-    // Check to see if it is audible, modify the params
-    // killough 3/7/98, 4/25/98: code rearranged slightly
+    // A new sound replaces the one of the same class from this origin.
+    RemoveVirtualVoices(origin, singularity);
 
-    if (!S_AdjustSoundParams(players[displayplayer].mo, origin, &params))
-    {
-        return false;
-    }
+    ScanChannels(origin, sfx, singularity, &scan);
 
-    // try to find a channel
-    if ((cnum = S_getChannel(origin, sfx, params.priority, singularity)) < 0)
+    if (S_RejectSound(origin, &scan, o_priority))
     {
+        if (snd_virtual_voices && !ambient)
+        {
+            AddVirtualVoice(sfx, origin, leveltime, o_priority, singularity,
+                            GetPitch(pitch_range));
+        }
         return false;
     }
 
-#ifdef RANGECHECK
-    if (cnum < 0 || cnum >= snd_channels)
-    {
-        I_Error("handle %d out of range\n", cnum);
-    }
-#endif
-
-    channels[cnum].sfxinfo = sfx;
+    // Check to see if it is audible, modify the params
+    // killough 3/7/98, 4/25/98: code rearranged slightly
 
-    while (sfx->link)
+    if (!S_AdjustSoundParams(players[displayplayer].mo, origin, &params))
     {
-        sfx = sfx->link; // sf: skip thru link(s)
+        return false;
     }
 
-    params.pitch = GetPitch(pitch_range);
-    params.offset = ambient ? GetAmbientSoundOffset(sfx, ambient) : 0.0f;
-
-    // Assigns the handle to one of the channels in the mix/output buffer.
-    handle = I_StartSound(sfx, &params);
-
-    // haleyjd: check to see if the sound was started
-    if (handle >= 0)
+    // try to find a channel
+    if ((cnum = S_getChannel(origin, &scan, params.priority)) < 0)
     {
-        // haleyjd 05/29/06: record volume scale value
-        // haleyjd 09/27/06: store priority and singularity values (!!!)
-        channels[cnum].origin = origin;
-        channels[cnum].handle = handle;
-        channels[cnum].ambient = ambient;
-        channels[cnum].close_dist = params.close_dist;
-        channels[cnum].clipping_dist = params.clipping_dist;
-        channels[cnum].stop_dist = params.stop_dist;
-        channels[cnum].volume_scale = params.volume_scale;
-        channels[cnum].o_priority = o_priority;    // original priority
-        channels[cnum].priority = params.priority; // scaled priority
-        channels[cnum].singularity = singularity;
-        channels[cnum].volume = params.volume;
-        channels[cnum].sfxinfo->active.count++;
-        LimitVolumePerSfx();
-
-        if (rumble_type != RUMBLE_NONE)
+        if (snd_virtual_voices && !ambient)
         {
-            I_StartRumble(players[displayplayer].mo, origin, sfx, handle,
-                          rumble_type);
+            AddVirtualVoice(sfx, origin, leveltime, o_priority, singularity,
+                            GetPitch(pitch_range));
         }
-    }
-    else // haleyjd: the sound didn't start, so clear the channel info
-    {
-        memset(&channels[cnum], 0, sizeof(channel_t));
         return false;
     }
 
-    return true;
+    params.pitch = GetPitch(pitch_range);
+
+    return StartChannel(cnum, sfx, origin, &params, o_priority, singularity,
+                        leveltime, rumble_type, ambient);
 }
 
 boolean S_StartAmbientSound(const mobj_t *origin, int sfx_id,
@@ -690,6 +904,8 @@ void S_StopSound(const mobj_t *origin)
         return;
     }
 
+    RemoveVirtualVoices(origin, -1);
+
     for (cnum = 0; cnum < snd_channels; ++cnum)
     {
         if (channels[cnum].sfxinfo && channels[cnum].origin == origin)
@@ -747,6 +963,8 @@ void S_UnlinkSound(mobj_t *origin)
 
     if (origin)
     {
+        RemoveVirtualVoices(origin, -1);
+
         for (cnum = 0; cnum < snd_channels; cnum++)
         {
             if (channels[cnum].sfxinfo && channels[cnum].origin == origin)
@@ -841,6 +1059,85 @@ void S_InitListener(const mobj_t *listener)
     I_ProcessSoundUpdates();
 }
 
+// Give free channels back to the highest priority virtual voices that are
+// audible. Voices never take a channel from a playing sound.
+
+static void PromoteVirtualVoices(const mobj_t *listener)
+{
+    for (int i = 0; i < num_virtual_voices;)
+    {
+        const virtual_voice_t *v = &virtual_voices[i];
+
+        if (SoundFinished(v->sfxinfo, v->start, v->pitch))
+        {
+            RemoveVirtualVoice(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    boolean tried[MAX_VIRTUAL_VOICES] = {0};
+
+    while (true)
+    {
+        int best = -1;
+
+        for (int i = 0; i < num_virtual_voices; i++)
+        {
+            if (!tried[i]
+                && (best < 0
+                    || virtual_voices[i].priority
+                           < virtual_voices[best].priority))
+            {
+                best = i;
+            }
+        }
+
+        if (best < 0)
+        {
+            break;
+        }
+
+        tried[best] = true;
+
+        const virtual_voice_t v = virtual_voices[best];
+        channel_scan_t scan;
+
+        ScanChannels(v.origin, v.sfxinfo, v.singularity, &scan);
+
+        if (scan.open < 0)
+        {
+            break;
+        }
+
+        if (scan.singular >= 0 || LimitChannelsPerSfx(v.origin, &scan))
+        {
+            continue;
+        }
+
+        sfxparams_t params;
+        params.close_dist = S_CLOSE_DIST;
+        params.clipping_dist = S_CLIPPING_DIST;
+        params.stop_dist = params.clipping_dist;
+        params.volume_scale = 127;
+        params.priority = v.priority;
+        params.pitch = v.pitch;
+
+        if (!S_AdjustSoundParams(listener, v.origin, &params))
+        {
+            continue;
+        }
+
+        RemoveVirtualVoice(best);
+        tried[best] = tried[num_virtual_voices];
+
+        StartChannel(scan.open, v.sfxinfo, v.origin, &params, v.priority,
+                     v.singularity, v.start, RUMBLE_NONE, NULL);
+    }
+}
+
 void S_UpdateSounds(const mobj_t *listener)
 {
     int cnum;
@@ -898,7 +1195,8 @@ void S_UpdateSounds(const mobj_t *listener)
         }
     }
 
-    LimitVolumePerSfx();
+    PromoteVirtualVoices(listener);
+    LimitVolumePerSfx(NULL);
     I_ProcessSoundUpdates();
     I_UpdateRumble();
 }
@@ -1142,6 +1440,8 @@ void S_Start(void)
                 S_StopChannel(cnum);
             }
         }
+
+        num_virtual_voices = 0;
     }
 
     // [crispy] don't load map's default music if loaded from a savegame with
@@ -1197,6 +1497,79 @@ void S_Start(void)
 //  allocates channel buffer, sets S_sfx lookup.
 //
 
+//
+// S_PrecacheLevel
+// If sound effects are decoded on first use, preload the sounds of all
+// things present on the map, so that the first encounter does not stall.
+//
+
+static void AddLevelSound(sfxinfo_t ***sfx_list, byte *hitlist, int sfx_id)
+{
+    if (sfx_id <= sfx_None || sfx_id >= num_sfx || hitlist[sfx_id])
+    {
+        return;
+    }
+
+    hitlist[sfx_id] = 1;
+
+    sfxinfo_t *sfx = &S_sfx[sfx_id];
+
+    while (sfx->link)
+    {
+        sfx = sfx->link;
+    }
+
+    if (sfx->name && !sfx->cached)
+    {
+        array_push(*sfx_list, sfx);
+    }
+}
+
+void S_PrecacheLevel(void)
+{
+    sfxinfo_t **sfx_list = NULL;
+    byte *hitlist, *typelist;
+
+    if (nosfxparm || snd_precache)
+    {
+        return;
+    }
+
+    hitlist = Z_Calloc(num_sfx, 1, PU_STATIC, NULL);
+    typelist = Z_Calloc(num_mobj_types, 1, PU_STATIC, NULL);
+
+    for (thinker_t *th = thinkercap.next; th != &thinkercap; th = th->next)
+    {
+        if (th->function.pm != P_MobjThinker)
+        {
+            continue;
+        }
+
+        const mobjtype_t type = ((mobj_t *)th)->type;
+
+        if (typelist[type])
+        {
+            continue;
+        }
+
+        typelist[type] = 1;
+
+        const mobjinfo_t *info = &mobjinfo[type];
+        AddLevelSound(&sfx_list, hitlist, info->seesound);
+        AddLevelSound(&sfx_list, hitlist, info->attacksound);
+        AddLevelSound(&sfx_list, hitlist, info->painsound);
+        AddLevelSound(&sfx_list, hitlist, info->deathsound);
+        AddLevelSound(&sfx_list, hitlist, info->activesound);
+        AddLevelSound(&sfx_list, hitlist, info->ripsound);
+    }
+
+    I_CacheSounds(sfx_list, array_size(sfx_list));
+
+    array_free(sfx_list);
+    Z_Free(typelist);
+    Z_Free(hitlist);
+}
+
 static void InitE4Music(void)
 {
     int i, j;
@@ -45,8 +45,14 @@ void S_Init(int sfxVolume, int musicVolume);
 //
 void S_Start(void);
 
+// Preload sound effects of the things on the current map.
+void S_PrecacheLevel(void);
+
 void S_EvictChannels(void);
 
+// Forget sounds waiting for a channel, after loading a key frame.
+void S_ClearVirtualVoices(void);
+
 //
 // Start sound for thing at <origin>
 //  using <sound_id> from sounds.h
@@ -74,6 +74,7 @@ static const char *sbw_names[] =
     [sbw_rate] = "render_stats",
     [sbw_cmd] = "command_history",
     [sbw_speed] = "speedometer",
+    [sbw_frame] = "frame_stats",
     [sbw_message] = "message",
     [sbw_announce] = "announce_level_title",
     [sbw_chat] = "chat",
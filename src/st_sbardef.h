@@ -136,6 +136,7 @@ typedef enum
     sbw_rate,
     sbw_cmd,
     sbw_speed,
+    sbw_frame,
 
     sbw_message,
     sbw_announce,
@@ -1469,6 +1469,51 @@ static void DrawLines(int x, int y, sbarelem_t *elem)
     }
 }
 
+// Frame time graph below the frame statistics widget, one bar per frame,
+// oldest first. Full height corresponds to 30 FPS.
+
+#define FRAMEGRAPH_HEIGHT 16
+#define FRAMEGRAPH_MAX_US (1000000 / 30)
+
+static void DrawFrameGraph(int x, int y, sbarelem_t *elem)
+{
+    sbe_widget_t *widget = elem->subtype.widget;
+
+    if (!array_size(widget->lines))
+    {
+        return;
+    }
+
+    y += array_size(widget->lines) * widget->font->maxheight + 1;
+
+    if (st_layout == st_wide && (elem->alignment & sbe_wide_left))
+    {
+        x -= video.deltaw;
+    }
+
+    const byte shade = cr_shaded[v_lightest_color];
+
+    for (int i = 0; i < FRAMETIME_HISTORY; ++i)
+    {
+        const int frametime =
+            frametimes[(frametime_index + i) % FRAMETIME_HISTORY];
+        const int height =
+            MIN(frametime, FRAMEGRAPH_MAX_US) * FRAMEGRAPH_HEIGHT
+            / FRAMEGRAPH_MAX_US;
+
+        if (height <= 0)
+        {
+            continue;
+        }
+
+        const byte color = frametime <= FRAMEGRAPH_MAX_US / 2 ? cr_green[shade]
+                           : frametime < FRAMEGRAPH_MAX_US    ? cr_gold[shade]
+                                                              : cr_red[shade];
+
+        V_FillRect(x + i, y + FRAMEGRAPH_HEIGHT - height, 1, height, color);
+    }
+}
+
 static void DrawElem(int x, int y, sbarelem_t *elem, player_t *player)
 {
     if (!CheckConditions(elem->conditions, player))
@@ -1532,6 +1577,10 @@ static void DrawElem(int x, int y, sbarelem_t *elem, player_t *player)
                 break;
             }
             DrawLines(x, y, elem);
+            if (elem->subtype.widget->type == sbw_frame)
+            {
+                DrawFrameGraph(x, y, elem);
+            }
             break;
 
         case sbe_carousel:
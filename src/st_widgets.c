@@ -24,6 +24,7 @@
 #include "doomstat.h"
 #include "doomtype.h"
 #include "dstrings.h"
+#include "g_rewind.h"
 #include "g_umapinfo.h"
 #include "hu_command.h"
 #include "hu_coordinates.h"
@@ -37,6 +38,7 @@
 #include "mn_menu.h"
 #include "p_mobj.h"
 #include "p_spec.h"
+#include "p_tick.h"
 #include "r_main.h"
 #include "r_voxel.h"
 #include "s_sound.h"
@@ -1030,6 +1032,57 @@ static void UpdateRate(sbe_widget_t *widget, player_t *player)
     }
 }
 
+boolean hud_frame_stats;
+
+static void UpdateFrameStats(sbe_widget_t *widget)
+{
+    ST_ClearLines(widget);
+
+    if (!hud_frame_stats)
+    {
+        return;
+    }
+
+    int min = INT_MAX, max = 0, total = 0, count = 0;
+
+    for (int i = 0; i < FRAMETIME_HISTORY; ++i)
+    {
+        if (frametimes[i] > 0)
+        {
+            min = MIN(min, frametimes[i]);
+            max = MAX(max, frametimes[i]);
+            total += frametimes[i];
+            count++;
+        }
+    }
+
+    if (!count)
+    {
+        min = 0;
+        count = 1;
+    }
+
+    static char line1[80];
+    M_snprintf(line1, sizeof(line1),
+               GRAY_S "Frame %5.2f ms Min %5.2f Max %5.2f   " GREEN_S "%dx%d",
+               total / 1000.0 / count, min / 1000.0, max / 1000.0,
+               video.width, video.height);
+    ST_AddLine(widget, line1);
+
+    static char line2[80];
+    M_snprintf(line2, sizeof(line2),
+               GRAY_S "Tic %5.2f ms Present %5.2f ms Thinkers %d",
+               tictime / 1000.0, presenttime / 1000.0, thinkers_run);
+    ST_AddLine(widget, line2);
+
+    static char line3[80];
+    M_snprintf(line3, sizeof(line3),
+               GRAY_S "Visplanes %d Drawsegs %d Sprites %d Openings %d",
+               rendered_visplanes, rendered_drawsegs, rendered_vissprites,
+               rendered_openings);
+    ST_AddLine(widget, line3);
+}
+
 int speedometer;
 
 static void UpdateSpeed(sbe_widget_t *widget, player_t *player)
@@ -1075,7 +1128,8 @@ boolean ST_DemoProgressBar(boolean force)
     const int progress = video.unscaledw * playback_tic / playback_totaltics;
     static int old_progress = 0;
 
-    if (old_progress < progress)
+    // progress goes back after seeking
+    if (old_progress != progress)
     {
         old_progress = progress;
     }
@@ -1087,6 +1141,14 @@ boolean ST_DemoProgressBar(boolean force)
     V_FillRect(0, SCREENHEIGHT - 2, progress, 1, v_darkest_color);
     V_FillRect(0, SCREENHEIGHT - 1, progress, 1, v_lightest_color);
 
+    // mark the demo key frames that can be seeked to
+    for (int i = 0; i < G_NumDemoKeyframes(); ++i)
+    {
+        const int x =
+            video.unscaledw * G_DemoKeyframeTic(i) / playback_totaltics;
+        V_FillRect(x, SCREENHEIGHT - 3, 1, 1, v_lightest_color);
+    }
+
     return true;
 }
 
@@ -1239,6 +1301,9 @@ void ST_UpdateWidget(sbarelem_t *elem, player_t *player)
         case sbw_speed:
             UpdateSpeed(widget, player);
             break;
+        case sbw_frame:
+            UpdateFrameStats(widget);
+            break;
         default:
             break;
     }
@@ -1271,6 +1336,8 @@ void ST_BindHUDVariables(void)
             "Hide empty commands from command history widget");
   M_BindBool("hud_time_use", &hud_time_use, NULL, false, ss_stat, wad_no,
              "Show split time when pressing the use-button");
+  BIND_BOOL(hud_frame_stats, false,
+            "Show frame time graph and render statistics widget");
   M_BindNum("hud_widget_font", &hud_widget_font, NULL,
             HUD_WIDGET_AUTOMAP, HUD_WIDGET_OFF, HUD_WIDGET_ALWAYS,
             ss_stat, wad_no,
@@ -74,6 +74,7 @@ char ST_DequeueChatChar(void);
 
 extern char **player_names[];
 extern int speedometer;
+extern boolean hud_frame_stats;
 
 extern int playback_tic, playback_totaltics;
 boolean ST_DemoProgressBar(boolean force);
@@ -30,7 +30,10 @@
 
 #include "v_flextran.h"
 
+#include <string.h>
+
 #include "i_video.h"
+#include "m_tasks.h"
 #include "w_wad.h"
 #include "z_zone.h"
 
@@ -47,15 +50,15 @@ typedef struct
     unsigned int r, g, b;
 } tpalcol_t;
 
-void V_InitFlexTranTable(void)
+static byte flextran_palette[256 * 3];
+
+static void BuildFlexTranTable(void *data)
 {
     int i, r, g, b, x, y;
-    tpalcol_t *tempRGBpal;
+    tpalcol_t tempRGBpal[256];
     const byte *palRover;
 
-    byte *palette = W_CacheLumpName("PLAYPAL", PU_STATIC);
-
-    tempRGBpal = Z_Malloc(256 * sizeof(*tempRGBpal), PU_STATIC, 0);
+    byte *palette = data;
 
     for (i = 0, palRover = palette; i < 256; i++, palRover += 3)
     {
@@ -102,7 +105,16 @@ void V_InitFlexTranTable(void)
     }
     Col2RGB8_LessPrecision[0] = Col2RGB8[0];
     Col2RGB8_LessPrecision[64] = Col2RGB8[64];
+}
 
-    Z_Free(tempRGBpal);
+// The tables are built by a worker thread, see M_WaitTasks().
+
+void V_InitFlexTranTable(void)
+{
+    byte *palette = W_CacheLumpName("PLAYPAL", PU_STATIC);
+    memcpy(flextran_palette, palette, sizeof(flextran_palette));
     Z_ChangeTag(palette, PU_CACHE);
+
+    M_AddTask("V_InitFlexTranTable", BuildFlexTranTable, flextran_palette,
+              NULL, 0);
 }
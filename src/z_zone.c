@@ -50,6 +50,9 @@ static const size_t HEADER_SIZE = (sizeof(memblock_t)+CHUNK_SIZE-1) & ~(CHUNK_SI
 
 static memblock_t *blockbytag[PU_MAX];
 
+size_t zone_allocs;
+size_t zone_bytes;
+
 // Z_Malloc
 // You can pass a NULL user if the tag is < PU_CACHE.
 
@@ -63,6 +66,9 @@ void *Z_Malloc(size_t size, pu_tag tag, void **user)
   if (!size)
     return user ? *user = NULL : NULL;           // malloc(0) returns NULL
 
+  zone_allocs++;
+  zone_bytes += size;
+
   while (!(block = malloc(size + HEADER_SIZE)))
   {
     if (!blockbytag[PU_CACHE])
@@ -51,6 +51,9 @@ void *Z_Realloc(void *p, size_t n, pu_tag tag, void **user);
 
 char *Z_StrDup(const char *orig, pu_tag tag);
 
+extern size_t zone_allocs; // number of Z_Malloc calls
+extern size_t zone_bytes;  // bytes requested from Z_Malloc
+
 #endif
 
 //----------------------------------------------------------------------------